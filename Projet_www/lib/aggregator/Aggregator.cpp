@@ -0,0 +1,82 @@
+#include "Aggregator.h"
+
+// --- Accumulateur d'une mesure ---
+struct Channel {
+  int32_t sum;
+  int16_t min, max;
+};
+
+enum { CH_TEMP, CH_HYGR, CH_PRESS, CH_LUMIN, CHANNEL_COUNT };
+
+static Channel channels[CHANNEL_COUNT];
+static uint8_t count = 0;
+static uint32_t firstTime = 0;
+static uint8_t errors[LOG_ERR_COUNT];
+static int32_t lat = 0, lon = 0;
+
+// Les mesures non signees sont decalees de 32768 pour partager le meme
+// accumulateur signe que la temperature.
+#define UNSIGNED_BIAS 32768L
+
+static void add(Channel &c, int32_t v) {
+  int16_t s = (int16_t)v;
+  if (count == 0 || s < c.min) c.min = s;
+  if (count == 0 || s > c.max) c.max = s;
+  c.sum += v;
+}
+
+static int32_t mean(const Channel &c) {
+  // Arrondi au plus proche, aussi pour les valeurs negatives
+  return c.sum >= 0 ? (c.sum + count / 2) / count : (c.sum - count / 2) / count;
+}
+
+void Aggregator_Add(const LogRecord &r) {
+  if (count == 0) {
+    memset(channels, 0, sizeof(channels));
+    memset(errors, 0, sizeof(errors));
+    firstTime = r.time;
+    lat = lon = 0;
+  }
+
+  add(channels[CH_TEMP], r.temperature);
+  add(channels[CH_HYGR], (int32_t)r.humidity - UNSIGNED_BIAS);
+  add(channels[CH_PRESS], (int32_t)r.pressure - UNSIGNED_BIAS);
+  add(channels[CH_LUMIN], (int32_t)r.luminosity - UNSIGNED_BIAS);
+
+  for (uint8_t b = 0; b < LOG_ERR_COUNT; b++) {
+    if ((r.errors & (1 << b)) && errors[b] < 0xFF) errors[b]++;
+  }
+  if (!(r.errors & LOG_ERR_GPS)) {
+    lat = r.lat;
+    lon = r.lon;
+  }
+  if (count < 0xFF) count++;
+}
+
+uint8_t Aggregator_Count() {
+  return count;
+}
+
+void Aggregator_Take(LogSummary &s) {
+  memset(&s, 0, sizeof(s));
+  s.time = firstTime;
+  s.count = count;
+  if (count) {
+    s.temperature[LOG_MIN] = channels[CH_TEMP].min;
+    s.temperature[LOG_MEAN] = mean(channels[CH_TEMP]);
+    s.temperature[LOG_MAX] = channels[CH_TEMP].max;
+    s.humidity[LOG_MIN] = channels[CH_HYGR].min + UNSIGNED_BIAS;
+    s.humidity[LOG_MEAN] = mean(channels[CH_HYGR]) + UNSIGNED_BIAS;
+    s.humidity[LOG_MAX] = channels[CH_HYGR].max + UNSIGNED_BIAS;
+    s.pressure[LOG_MIN] = channels[CH_PRESS].min + UNSIGNED_BIAS;
+    s.pressure[LOG_MEAN] = mean(channels[CH_PRESS]) + UNSIGNED_BIAS;
+    s.pressure[LOG_MAX] = channels[CH_PRESS].max + UNSIGNED_BIAS;
+    s.luminosity[LOG_MIN] = channels[CH_LUMIN].min + UNSIGNED_BIAS;
+    s.luminosity[LOG_MEAN] = mean(channels[CH_LUMIN]) + UNSIGNED_BIAS;
+    s.luminosity[LOG_MAX] = channels[CH_LUMIN].max + UNSIGNED_BIAS;
+    memcpy(s.errors, errors, sizeof(errors));
+    s.lat = lat;
+    s.lon = lon;
+  }
+  count = 0;
+}
@@ -0,0 +1,16 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include <Arduino.h>
+#include <LogFormat.h>
+
+// Agregation des acquisitions en fenetres de AGG_WINDOW echantillons : min,
+// moyenne et max par mesure, nombre d'echantillons par bit d'erreur. Un seul
+// enregistrement est ecrit sur la carte SD par fenetre.
+
+// --- Fonctions publiques ---
+void Aggregator_Add(const LogRecord &record);
+uint8_t Aggregator_Count();
+void Aggregator_Take(LogSummary &summary);   // resume la fenetre courante et la remet a zero
+
+#endif // AGGREGATOR_H
@@ -0,0 +1,121 @@
+#include "Backlog.h"
+
+#define SLOT_SIZE sizeof(LogRecord)
+static_assert(sizeof(LogSummary) <= 2 * SLOT_SIZE, "LogSummary doit tenir dans deux places");
+static_assert(BACKLOG_DEPTH >= 2 && BACKLOG_DEPTH <= 16, "BACKLOG_DEPTH hors de 2..16");
+
+static uint8_t slots[BACKLOG_DEPTH][SLOT_SIZE];
+static uint16_t wide = 0;     // bit i : la place i commence une fenetre (deux places)
+static uint8_t head = 0;      // premiere place du plus ancien enregistrement
+static uint8_t used = 0;      // places occupees
+static uint8_t count = 0;
+static uint8_t maxCount = 0;
+static uint16_t dropped = 0;
+
+static uint8_t advance(uint8_t slot, uint8_t n) {
+  slot += n;
+  if (slot >= BACKLOG_DEPTH) slot -= BACKLOG_DEPTH;
+  return slot;
+}
+
+static uint8_t entrySlots(uint8_t slot) {
+  return (wide >> slot) & 1 ? 2 : 1;
+}
+
+// --- Echantillon seul <-> LogRecord, sans perte : min = moyenne = max ---
+static void toRecord(const LogSummary &s, LogRecord &r) {
+  r.time = s.time;
+  r.temperature = s.temperature[LOG_MEAN];
+  r.humidity = s.humidity[LOG_MEAN];
+  r.pressure = s.pressure[LOG_MEAN];
+  r.luminosity = s.luminosity[LOG_MEAN];
+  r.errors = 0;
+  for (uint8_t b = 0; b < LOG_ERR_COUNT; b++) {
+    if (s.errors[b]) r.errors |= 1 << b;
+  }
+  r.lat = s.lat;
+  r.lon = s.lon;
+}
+
+static void toSummary(const LogRecord &r, LogSummary &s) {
+  memset(&s, 0, sizeof(s));
+  s.time = r.time;
+  s.count = 1;
+  for (uint8_t i = LOG_MIN; i <= LOG_MAX; i++) {
+    s.temperature[i] = r.temperature;
+    s.humidity[i] = r.humidity;
+    s.pressure[i] = r.pressure;
+    s.luminosity[i] = r.luminosity;
+  }
+  for (uint8_t b = 0; b < LOG_ERR_COUNT; b++) s.errors[b] = (r.errors >> b) & 1;
+  s.lat = r.lat;
+  s.lon = r.lon;
+}
+
+void Backlog_Push(const LogSummary &summary) {
+  uint8_t need = summary.count == 1 ? 1 : 2;
+  while (used + need > BACKLOG_DEPTH) {
+    // Pleine : le plus ancien est perdu
+    Backlog_Pop();
+    if (dropped < 0xFFFF) dropped++;
+  }
+
+  uint8_t tail = advance(head, used);
+  if (need == 1) {
+    LogRecord r;
+    toRecord(summary, r);
+    memcpy(slots[tail], &r, SLOT_SIZE);
+    wide &= ~(1U << tail);
+  }
+  else {
+    // Fenetre coupee en deux places, eventuellement de part et d'autre de la fin du tableau
+    const uint8_t *p = (const uint8_t*)&summary;
+    memcpy(slots[tail], p, SLOT_SIZE);
+    memcpy(slots[advance(tail, 1)], p + SLOT_SIZE, sizeof(LogSummary) - SLOT_SIZE);
+    wide |= 1U << tail;
+  }
+  used += need;
+  if (++count > maxCount) maxCount = count;
+}
+
+bool Backlog_Peek(LogSummary &summary, uint8_t index) {
+  if (index >= count) return false;
+  uint8_t slot = head;
+  while (index--) slot = advance(slot, entrySlots(slot));
+
+  if (entrySlots(slot) == 1) {
+    LogRecord r;
+    memcpy(&r, slots[slot], SLOT_SIZE);
+    toSummary(r, summary);
+  }
+  else {
+    uint8_t *p = (uint8_t*)&summary;
+    memcpy(p, slots[slot], SLOT_SIZE);
+    memcpy(p + SLOT_SIZE, slots[advance(slot, 1)], sizeof(LogSummary) - SLOT_SIZE);
+  }
+  return true;
+}
+
+void Backlog_Pop() {
+  if (!count) return;
+  uint8_t n = entrySlots(head);
+  head = advance(head, n);
+  used -= n;
+  count--;
+}
+
+uint8_t Backlog_Count() {
+  return count;
+}
+
+uint8_t Backlog_Slots() {
+  return used;
+}
+
+uint8_t Backlog_MaxCount() {
+  return maxCount;
+}
+
+uint16_t Backlog_Dropped() {
+  return dropped;
+}
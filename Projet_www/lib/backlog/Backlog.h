@@ -0,0 +1,30 @@
+#ifndef BACKLOG_H
+#define BACKLOG_H
+
+#include <Arduino.h>
+#include <LogFormat.h>
+
+// File d'attente en RAM des enregistrements qui n'ont pas pu etre ecrits sur
+// la carte SD (absente, pleine). L'EEPROM est deja entierement occupee par
+// ConfigStore et ErrorJournal : la file est bornee et perd son plus ancien
+// enregistrement quand elle deborde.
+//
+// Places de sizeof(LogRecord) = 21 octets : un echantillon seul (count == 1,
+// AGG_WINDOW = 1) est garde en LogRecord et occupe une place, une fenetre
+// agregee occupe deux places (LogSummary, 42 octets). Duree couverte :
+// BACKLOG_DEPTH x LOG_INTERVAL sans agregation (80 s par defaut, 320 s en ECO),
+// BACKLOG_DEPTH / 2 x AGG_WINDOW x LOG_INTERVAL avec.
+#ifndef BACKLOG_DEPTH
+#define BACKLOG_DEPTH 8     // 168 octets, la RAM de 4 LogSummary
+#endif
+
+// --- Fonctions publiques ---
+void Backlog_Push(const LogSummary &summary);
+bool Backlog_Peek(LogSummary &summary, uint8_t index = 0);   // index 0 : le plus ancien, laisse en place
+void Backlog_Pop();
+uint8_t Backlog_Count();                  // enregistrements en attente
+uint8_t Backlog_Slots();                  // places occupees, sur BACKLOG_DEPTH
+uint8_t Backlog_MaxCount();               // profondeur maximale atteinte
+uint16_t Backlog_Dropped();
+
+#endif // BACKLOG_H
@@ -0,0 +1,125 @@
+// Boutons sur interruptions externes.
+//
+// Les ISR de INT0/INT1 horodatent les fronts, filtrent les rebonds et les
+// deposent dans une petite file. ButtonManager_Update(), dans le contexte
+// principal, vide la file et classe les appuis (court / long) : la reactivite
+// ne depend plus de la frequence de loop(). Un front peut reveiller le MCU du
+// sommeil eco : il est horodate avec PowerManager_Millis(), pas millis().
+
+#include "ButtonManager.h"
+#include <PowerManager.h>
+
+#define EVENT_QUEUE_SIZE 8   // puissance de 2
+
+struct ButtonEvent {
+  uint8_t button;
+  bool pressed;
+  unsigned long time;
+};
+
+static uint8_t pins[BUTTON_COUNT];
+
+// --- Partage avec les ISR ---
+static volatile ButtonEvent queue[EVENT_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0, queueTail = 0;
+static volatile bool stableState[BUTTON_COUNT];        // true = appuye
+static volatile unsigned long lastEdge[BUTTON_COUNT];
+
+// --- Contexte principal ---
+static unsigned long pressStart[BUTTON_COUNT];
+static bool held[BUTTON_COUNT];
+static bool longDone[BUTTON_COUNT];
+static uint8_t actions[BUTTON_COUNT];
+
+// --- Appele depuis l'ISR (ou interruptions coupees) ---
+static void pushEvent(uint8_t b, bool pressed, unsigned long now) {
+  stableState[b] = pressed;
+  lastEdge[b] = now;
+  uint8_t next = (queueHead + 1) & (EVENT_QUEUE_SIZE - 1);
+  if (next == queueTail) return;   // file pleine : l'etat stable reste a jour
+  queue[queueHead].button = b;
+  queue[queueHead].pressed = pressed;
+  queue[queueHead].time = now;
+  queueHead = next;
+}
+
+static void onEdge(uint8_t b) {
+  unsigned long now = PowerManager_Millis();
+  bool pressed = digitalRead(pins[b]) == LOW;
+  if (pressed == stableState[b]) return;
+  if (now - lastEdge[b] < BUTTON_DEBOUNCE_MS) return;   // rebond
+  pushEvent(b, pressed, now);
+}
+
+static void isr0() { onEdge(0); }
+static void isr1() { onEdge(1); }
+
+void ButtonManager_Init(uint8_t pin0, uint8_t pin1) {
+  pins[0] = pin0;
+  pins[1] = pin1;
+  for (uint8_t b = 0; b < BUTTON_COUNT; b++) {
+    pinMode(pins[b], INPUT_PULLUP);
+    stableState[b] = digitalRead(pins[b]) == LOW;
+  }
+  attachInterrupt(digitalPinToInterrupt(pin0), isr0, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(pin1), isr1, CHANGE);
+  Serial.println(F("[INFO] ButtonManager initialisé"));
+}
+
+void ButtonManager_Update() {
+  unsigned long now = millis();
+
+  // Un front ignore pendant la fenetre anti-rebond peut laisser l'etat stable
+  // en retard sur la broche : on le resynchronise une fois la fenetre passee.
+  for (uint8_t b = 0; b < BUTTON_COUNT; b++) {
+    bool pressed = digitalRead(pins[b]) == LOW;
+    noInterrupts();
+    if (pressed != stableState[b] && now - lastEdge[b] >= BUTTON_DEBOUNCE_MS) pushEvent(b, pressed, now);
+    interrupts();
+  }
+
+  // Vidage de la file
+  while (queueTail != queueHead) {
+    noInterrupts();
+    ButtonEvent e;
+    e.button = queue[queueTail].button;
+    e.pressed = queue[queueTail].pressed;
+    e.time = queue[queueTail].time;
+    queueTail = (queueTail + 1) & (EVENT_QUEUE_SIZE - 1);
+    interrupts();
+
+    uint8_t b = e.button;
+    if (e.pressed) {
+      held[b] = true;
+      longDone[b] = false;
+      pressStart[b] = e.time;
+      actions[b] |= BUTTON_PRESS;
+    } else if (held[b]) {
+      held[b] = false;
+      if (!longDone[b] && e.time - pressStart[b] < BUTTON_LONG_PRESS_MS) actions[b] |= BUTTON_SHORT;
+    }
+  }
+
+  // Appui long : detecte pendant le maintien, sans attendre le relachement
+  for (uint8_t b = 0; b < BUTTON_COUNT; b++) {
+    if (held[b] && !longDone[b] && now - pressStart[b] >= BUTTON_LONG_PRESS_MS) {
+      longDone[b] = true;
+      actions[b] |= BUTTON_LONG;
+    }
+  }
+}
+
+uint8_t ButtonManager_Take(uint8_t button) {
+  uint8_t a = actions[button];
+  actions[button] = BUTTON_NONE;
+  return a;
+}
+
+bool ButtonManager_IsHeld(uint8_t button) {
+  return stableState[button];
+}
+
+bool ButtonManager_AnyHeld() {
+  for (uint8_t b = 0; b < BUTTON_COUNT; b++) if (stableState[b]) return true;
+  return false;
+}
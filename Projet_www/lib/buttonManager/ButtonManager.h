@@ -0,0 +1,30 @@
+#ifndef BUTTON_MANAGER_H
+#define BUTTON_MANAGER_H
+
+#include <Arduino.h>
+
+#define BUTTON_COUNT 2
+
+#ifndef BUTTON_DEBOUNCE_MS
+#define BUTTON_DEBOUNCE_MS 30
+#endif
+#ifndef BUTTON_LONG_PRESS_MS
+#define BUTTON_LONG_PRESS_MS 5000
+#endif
+
+// --- Actions, classees dans le contexte principal ---
+typedef enum : uint8_t {
+  BUTTON_NONE  = 0,
+  BUTTON_PRESS = 0x01,   // front d'appui (debounce)
+  BUTTON_SHORT = 0x02,   // relache avant BUTTON_LONG_PRESS_MS
+  BUTTON_LONG  = 0x04    // maintenu BUTTON_LONG_PRESS_MS, signale une seule fois
+} ButtonAction;
+
+// --- Fonctions publiques ---
+void ButtonManager_Init(uint8_t pin0, uint8_t pin1);   // broches INT0 / INT1
+void ButtonManager_Update();
+uint8_t ButtonManager_Take(uint8_t button);            // masque de ButtonAction, remis a zero
+bool ButtonManager_IsHeld(uint8_t button);
+bool ButtonManager_AnyHeld();
+
+#endif // BUTTON_MANAGER_H
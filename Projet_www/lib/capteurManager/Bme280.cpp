@@ -0,0 +1,152 @@
+// Pilote BME280 minimal : mode force, une seule lecture en rafale par mesure,
+// compensation entiere (formules 32 bits de la fiche technique Bosch).
+// Entre deux mesures le capteur reste en sommeil.
+
+#include "Bme280.h"
+#include <Wire.h>
+
+// --- Registres ---
+#define REG_CALIB_TP   0x88   // 0x88..0xA1 : T1..T3, P1..P9, H1
+#define REG_CHIP_ID    0xD0
+#define REG_RESET      0xE0
+#define REG_CALIB_H    0xE1   // 0xE1..0xE7 : H2..H6
+#define REG_CTRL_HUM   0xF2
+#define REG_STATUS     0xF3
+#define REG_CTRL_MEAS  0xF4
+#define REG_CONFIG     0xF5
+#define REG_DATA       0xF7   // 0xF7..0xFE : pression, temperature, humidite
+
+#define CHIP_ID        0x60
+#define MODE_FORCED    0x01
+#define STATUS_MEASURING 0x08
+#define MEASURE_TIMEOUT_MS 100
+
+static uint8_t addr = 0x76;
+
+// --- Coefficients d'etalonnage, lus une fois au demarrage ---
+static struct {
+  uint16_t T1; int16_t T2, T3;
+  uint16_t P1; int16_t P2, P3, P4, P5, P6, P7, P8, P9;
+  uint8_t H1; int16_t H2; uint8_t H3; int16_t H4, H5; int8_t H6;
+} calib;
+
+static bool readRegs(uint8_t reg, uint8_t *buf, uint8_t len) {
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0) return false;
+  if (Wire.requestFrom(addr, len) != len) return false;
+  for (uint8_t i = 0; i < len; i++) buf[i] = Wire.read();
+  return true;
+}
+
+static bool writeReg(uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  Wire.write(value);
+  return Wire.endTransmission() == 0;
+}
+
+static uint16_t le16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+bool Bme280_Init(uint8_t address) {
+  addr = address;
+  uint8_t id;
+  if (!readRegs(REG_CHIP_ID, &id, 1) || id != CHIP_ID) return false;
+
+  writeReg(REG_RESET, 0xB6);
+  delay(3);
+
+  uint8_t b[26];
+  if (!readRegs(REG_CALIB_TP, b, 26)) return false;
+  calib.T1 = le16(b + 0);  calib.T2 = le16(b + 2);  calib.T3 = le16(b + 4);
+  calib.P1 = le16(b + 6);  calib.P2 = le16(b + 8);  calib.P3 = le16(b + 10);
+  calib.P4 = le16(b + 12); calib.P5 = le16(b + 14); calib.P6 = le16(b + 16);
+  calib.P7 = le16(b + 18); calib.P8 = le16(b + 20); calib.P9 = le16(b + 22);
+  calib.H1 = b[25];
+
+  if (!readRegs(REG_CALIB_H, b, 7)) return false;
+  calib.H2 = le16(b + 0);
+  calib.H3 = b[2];
+  calib.H4 = ((int16_t)(int8_t)b[3] << 4) | (b[4] & 0x0F);
+  calib.H5 = ((int16_t)(int8_t)b[5] << 4) | (b[4] >> 4);
+  calib.H6 = (int8_t)b[6];
+
+  // Pas de filtre IIR, capteur en sommeil jusqu'a la premiere mesure
+  return writeReg(REG_CONFIG, 0x00) && writeReg(REG_CTRL_MEAS, 0x00);
+}
+
+// --- Compensation (fiche technique BME280, section 4.2.3) ---
+static int32_t compensateT(int32_t adc, int32_t &tFine) {
+  int32_t var1 = ((((adc >> 3) - ((int32_t)calib.T1 << 1))) * calib.T2) >> 11;
+  int32_t var2 = (((((adc >> 4) - calib.T1) * ((adc >> 4) - calib.T1)) >> 12) * calib.T3) >> 14;
+  tFine = var1 + var2;
+  return (tFine * 5 + 128) >> 8;                      // 0.01 °C
+}
+
+static uint32_t compensateP(int32_t adc, int32_t tFine) {
+  int32_t var1 = (tFine >> 1) - 64000;
+  int32_t var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * calib.P6;
+  var2 = var2 + ((var1 * calib.P5) << 1);
+  var2 = (var2 >> 2) + ((int32_t)calib.P4 << 16);
+  var1 = (((calib.P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((calib.P2 * var1) >> 1)) >> 18;
+  var1 = ((32768 + var1) * (int32_t)calib.P1) >> 15;
+  if (var1 == 0) return 0;
+
+  uint32_t p = ((uint32_t)(1048576 - adc) - (var2 >> 12)) * 3125;
+  if (p < 0x80000000UL) p = (p << 1) / (uint32_t)var1;
+  else p = (p / (uint32_t)var1) * 2;
+  var1 = ((int32_t)calib.P9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+  var2 = ((int32_t)(p >> 2) * calib.P8) >> 13;
+  return (uint32_t)((int32_t)p + ((var1 + var2 + calib.P7) >> 4));   // Pa
+}
+
+static uint32_t compensateH(int32_t adc, int32_t tFine) {
+  int32_t v = tFine - 76800;
+  v = (((((adc << 14) - ((int32_t)calib.H4 << 20) - ((int32_t)calib.H5 * v)) + 16384) >> 15) *
+       (((((((v * calib.H6) >> 10) * (((v * (int32_t)calib.H3) >> 11) + 32768)) >> 10) + 2097152) *
+         calib.H2 + 8192) >> 14));
+  v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)calib.H1) >> 4);
+  if (v < 0) v = 0;
+  if (v > 419430400) v = 419430400;
+  return (uint32_t)(v >> 12);                         // %RH en Q22.10
+}
+
+bool Bme280_Read(uint8_t channels, Bme280Data &out) {
+  out.temperature = 0;
+  out.humidity = 0;
+  out.pressure = 0;
+  if (!channels) return true;
+
+  // La temperature sert a compenser les deux autres canaux : toujours mesuree.
+  // Les canaux non demandes sont coupes, la conversion est plus courte.
+  uint8_t osrsH = (channels & BME280_HUM) ? BME280_OVERSAMPLING : 0;
+  uint8_t osrsP = (channels & BME280_PRESS) ? BME280_OVERSAMPLING : 0;
+  uint8_t osrsT = BME280_OVERSAMPLING;
+
+  // ctrl_hum n'est pris en compte qu'apres une ecriture de ctrl_meas
+  if (!writeReg(REG_CTRL_HUM, osrsH)) return false;
+  if (!writeReg(REG_CTRL_MEAS, (osrsT << 5) | (osrsP << 2) | MODE_FORCED)) return false;
+
+  // Attente de fin de conversion ; le capteur repasse seul en sommeil
+  unsigned long start = millis();
+  uint8_t status;
+  do {
+    delay(1);
+    if (!readRegs(REG_STATUS, &status, 1)) return false;
+    if (millis() - start > MEASURE_TIMEOUT_MS) return false;
+  } while (status & STATUS_MEASURING);
+
+  // Une seule lecture en rafale des 8 registres de mesure
+  uint8_t b[8];
+  if (!readRegs(REG_DATA, b, 8)) return false;
+  int32_t adcP = ((uint32_t)b[0] << 12) | ((uint32_t)b[1] << 4) | (b[2] >> 4);
+  int32_t adcT = ((uint32_t)b[3] << 12) | ((uint32_t)b[4] << 4) | (b[5] >> 4);
+  int32_t adcH = ((uint32_t)b[6] << 8) | b[7];
+
+  int32_t tFine;
+  int32_t t = compensateT(adcT, tFine);
+  if (channels & BME280_TEMP) out.temperature = t;
+  if (channels & BME280_HUM) out.humidity = (compensateH(adcH, tFine) * 100) >> 10;
+  if (channels & BME280_PRESS) out.pressure = (compensateP(adcP, tFine) + 5) / 10;
+  return true;
+}
@@ -0,0 +1,27 @@
+#ifndef BME280_H
+#define BME280_H
+
+#include <Arduino.h>
+
+// --- Sur-echantillonnage (0 = canal coupe, 1..5 = x1, x2, x4, x8, x16) ---
+#ifndef BME280_OVERSAMPLING
+#define BME280_OVERSAMPLING 1
+#endif
+
+// --- Canaux demandes a Bme280_Read() ---
+#define BME280_TEMP   0x01
+#define BME280_HUM    0x02
+#define BME280_PRESS  0x04
+
+// --- Resultat compense, en virgule fixe ---
+struct Bme280Data {
+  int16_t  temperature;   // centiemes de °C
+  uint16_t humidity;      // centiemes de %RH
+  uint16_t pressure;      // dixiemes de hPa
+};
+
+// --- Fonctions publiques ---
+bool Bme280_Init(uint8_t address);
+bool Bme280_Read(uint8_t channels, Bme280Data &out);
+
+#endif // BME280_H
@@ -1,44 +1,90 @@
 #include <Arduino.h>
-#include <Adafruit_BME280.h>
+#include <Wire.h>
 #include <SoftwareSerial.h>
 #include <LedManager.h>
-#include <EEPROM.h>
+#include <ErrorJournal.h>
+#include <LogFormat.h>
 #include <ConfigManager.h>
 #include <TinyGPSPlus.h>
+#include <RecordFormatter.h>
+#include <clockManager.h>
+#include "CapteurManager.h"
+#include "Bme280.h"
 
 #define GPS_RX 7
 #define GPS_TX 8
 #define LUMINOSITY_PIN A0
 
+// Trames utiles seulement : RMC (date, heure, position) et GGA (satellites, HDOP)
+static const char GPS_NMEA_FILTER[] PROGMEM = "$PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*28\r\n";
+// Veille du recepteur ; n'importe quel octet recu le reveille
+static const char GPS_STANDBY[] PROGMEM = "$PMTK161,0*28\r\n";
+
+// --- Contexte des erreurs ERROR_SENSOR_ACCESS (journal des erreurs) ---
+#define SENSOR_CTX_INIT   0    // BME280 absent au demarrage
+#define SENSOR_CTX_ABSENT 1    // lecture demandee sans capteur
+#define SENSOR_CTX_READ   2    // echec de la conversion / lecture I2C
+
 // --- Objets globaux ---
 SoftwareSerial gpsSerial(GPS_RX, GPS_TX);
 TinyGPSPlus gps;
-Adafruit_BME280 bme;
 
 bool bmeOK = false;
 
-Parametres configParams;
+// --- Derniere position connue, mise a jour en continu depuis loop() ---
+static struct {
+  int32_t lat, lon;         // millioniemes de degre
+  unsigned long fixTime;    // millis() de la derniere position
+  uint16_t hdop;            // centiemes
+  uint8_t satellites;
+  bool valid;
+} lastFix;
+
+static uint16_t gpsOverflows = 0;
+static bool gpsStandby = false;
 
-struct SensorData {
-  float  temperature;   // °C
-  float  humidity;      // %RH
-  float  pressure;      // hPa
-  int    luminosity;    // 0..1023
-  bool   tempError;
-  bool   hygrError;
-  bool   pressError;
-  bool   luminError;
-};
+static void gpsSend(const char *cmd) {
+  for (const char *p = cmd; pgm_read_byte(p); p++) gpsSerial.write(pgm_read_byte(p));
+}
+
+// --- Seuils derives de la configuration, a l'echelle des mesures ---
+static struct {
+  uint8_t version;
+  uint8_t channels;         // BME280_*
+  bool lumin;
+  int16_t tempMin, tempMax; // centiemes de °C
+  int16_t hygrMin, hygrMax; // centiemes de °C (plage de validite de l'hygrometrie)
+  uint16_t pressMin, pressMax; // dixiemes de hPa
+  int lumLow, lumHigh;
+} cfg;
+
+static void refreshConfig() {
+  if (cfg.version == ConfigManager_Version()) return;
+  cfg.version = ConfigManager_Version();
+  cfg.channels = (configParams.TEMP_AIR ? BME280_TEMP : 0) |
+                 (configParams.HYGR ? BME280_HUM : 0) |
+                 (configParams.PRESSURE ? BME280_PRESS : 0);
+  cfg.lumin = configParams.LUMIN;
+  cfg.tempMin = configParams.MIN_TEMP_AIR * 100;
+  cfg.tempMax = configParams.MAX_TEMP_AIR * 100;
+  cfg.hygrMin = configParams.HYGR_MINT * 100;
+  cfg.hygrMax = configParams.HYGR_MAXT * 100;
+  cfg.pressMin = configParams.PRESSURE_MIN * 10;
+  cfg.pressMax = configParams.PRESSURE_MAX * 10;
+  cfg.lumLow = configParams.LUMIN_LOW;
+  cfg.lumHigh = configParams.LUMIN_HIGH;
+}
 
 // ------------------ Initialisation ------------------
 bool init_capteur() {
   gpsSerial.begin(9600);
+  gpsSend(GPS_NMEA_FILTER);
   Wire.begin();
 
-  bmeOK = bme.begin(0x76);
+  bmeOK = Bme280_Init(0x76);
   if (!bmeOK) {
     Serial.println(F("[ERROR] capteur BME280 non detecte !"));
-    LedManager_Feedback(ERROR_SENSOR_ACCESS);
+    ErrorJournal_Report(ERROR_SENSOR_ACCESS, SENSOR_CTX_INIT);
     return false;
   }
 
@@ -52,51 +98,108 @@ SensorData readSensors()
 {
   SensorData d = {};
   if (!bmeOK) {
-    LedManager_Feedback(ERROR_SENSOR_ACCESS);
+    ErrorJournal_Report(ERROR_SENSOR_ACCESS, SENSOR_CTX_ABSENT);
     return d;
   }
 
-  EEPROM.get(0, configParams);
+  refreshConfig();
 
-  if( configParams.TEMP_AIR ){  d.temperature = bme.readTemperature();}else{d.temperature=0.0;}
-  if( configParams.HYGR ){ d.humidity = bme.readHumidity();}else{d.humidity=0.0;}
-  if( configParams.PRESSURE ){ d.pressure = bme.readPressure() * 0.01F;}else{d.pressure =215.0;}
-  if( configParams.LUMIN ){ d.luminosity = analogRead(LUMINOSITY_PIN);}else{d.luminosity=0;}
+  // Une seule conversion en mode force pour les canaux actives
+  Bme280Data m;
+  if (!Bme280_Read(cfg.channels, m)) {
+    ErrorJournal_Report(ERROR_SENSOR_ACCESS, SENSOR_CTX_READ);
+    return d;
+  }
+
+  d.temperature = m.temperature;
+  d.humidity = m.humidity;
+  if( cfg.channels & BME280_PRESS ){ d.pressure = m.pressure;}else{d.pressure =2150;}
+  if( cfg.lumin ){ d.luminosity = analogRead(LUMINOSITY_PIN);}else{d.luminosity=0;}
 
-  d.tempError = (d.temperature < configParams.MIN_TEMP_AIR || d.temperature > configParams.MAX_TEMP_AIR);
-  d.hygrError = (d.temperature < configParams.HYGR_MINT || d.temperature > configParams.HYGR_MAXT);
-  d.pressError = (d.pressure < configParams.PRESSURE_MIN || d.pressure > configParams.PRESSURE_MAX);
-  d.luminError = (d.luminosity < configParams.LUMIN_LOW || d.luminosity > configParams.LUMIN_HIGH);
+  d.tempError = (d.temperature < cfg.tempMin || d.temperature > cfg.tempMax);
+  d.hygrError = (d.temperature < cfg.hygrMin || d.temperature > cfg.hygrMax);
+  d.pressError = (d.pressure < cfg.pressMin || d.pressure > cfg.pressMax);
+  d.luminError = ((int)d.luminosity < cfg.lumLow || (int)d.luminosity > cfg.lumHigh);
 
   if (d.tempError || d.pressError)
-  { 
-    LedManager_Feedback(ERROR_SENSOR_INCOHERENT);
+  {
+    // Contexte : bits LOG_ERR_* des mesures hors limites
+    ErrorJournal_Report(ERROR_SENSOR_INCOHERENT, (d.tempError ? LOG_ERR_TEMP : 0) | (d.pressError ? LOG_ERR_PRESS : 0));
   }
 
   return d;
 }
 
-float convertToDecimal(String coord, String dir) {
-  float raw = coord.toFloat();
-  int deg = (int)(raw / 100);
-  float min = raw - (deg * 100);
-  float decimal = deg + (min / 60.0);
-  if (dir == F("S") || dir == F("W")) decimal *= -1;
-  return decimal;
+// --- Degres bruts TinyGPS (degres + milliardiemes) -> millioniemes de degre, sans float ---
+static int32_t toMicroDegrees(const RawDegrees &raw) {
+  int32_t v = raw.deg * 1000000L + (raw.billionths + 500) / 1000;
+  return raw.negative ? -v : v;
 }
 
-bool readGPS(float &lat, float &lon)
+// --- Lecture incrementale du flux NMEA, au plus GPS_BYTES_PER_UPDATE octets par appel ---
+void CapteurManager_UpdateGPS()
 {
-  while (gpsSerial.available())
-  {
-    char c = gpsSerial.read();
-    gps.encode(c);
-  }
-  if (gps.location.isValid())
+  if (gpsSerial.overflow()) gpsOverflows++;
+
+  for (uint8_t n = 0; n < GPS_BYTES_PER_UPDATE && gpsSerial.available(); n++)
   {
-    lat = gps.location.lat();
-    lon = gps.location.lng();
-    return true;
+    if (!gps.encode(gpsSerial.read())) continue;
+
+    // Trame complete : mise a jour du cache
+    if (gps.location.isUpdated() && gps.location.isValid())
+    {
+      lastFix.lat = toMicroDegrees(gps.location.rawLat());
+      lastFix.lon = toMicroDegrees(gps.location.rawLng());
+      lastFix.fixTime = millis();
+      lastFix.valid = true;
+    }
+    if (gps.satellites.isUpdated()) lastFix.satellites = gps.satellites.value();
+    if (gps.hdop.isUpdated()) lastFix.hdop = gps.hdop.value();
+
+    // Trame RMC avec position : date et heure UTC fiables pour recaler l'horloge.
+    // Les deux doivent venir de la meme trame (une GGA ne porte pas la date).
+    if (gps.date.isUpdated() && gps.time.isUpdated() && gps.date.isValid() && gps.time.isValid() &&
+        lastFix.valid && millis() - lastFix.fixTime < 2000 && gps.date.year() >= 2020)
+    {
+      Clock_DisciplineFromGps(Clock_ToEpoch(gps.date.year(), gps.date.month(), gps.date.day(),
+                                            gps.time.hour(), gps.time.minute(), gps.time.second()));
+    }
   }
-  return false;
-}
\ No newline at end of file
+}
+
+// --- Position en cache, temps constant ---
+bool readGPS(int32_t &lat, int32_t &lon)
+{
+  if (!lastFix.valid || millis() - lastFix.fixTime > GPS_MAX_FIX_AGE_MS) return false;
+  lat = lastFix.lat;
+  lon = lastFix.lon;
+  return true;
+}
+
+// --- Mise en veille / reveil du recepteur GPS (mode economique) ---
+void CapteurManager_GPSStandby(bool standby)
+{
+  if (standby == gpsStandby) return;
+  gpsStandby = standby;
+  if (standby) gpsSend(GPS_STANDBY);
+  else gpsSerial.write('\n');
+}
+
+void CapteurManager_PrintGPSStats()
+{
+  Serial.println(F("=== GPS ==="));
+  Serial.print(F("Position: "));
+  if (lastFix.valid) {
+    RecordFormatter_PrintFixed(Serial, lastFix.lat, 6); Serial.print(' ');
+    RecordFormatter_PrintFixed(Serial, lastFix.lon, 6);
+    Serial.print(F(" (age ")); Serial.print((millis() - lastFix.fixTime) / 1000); Serial.println(F(" s)"));
+  } else Serial.println(F("aucune"));
+  Serial.print(F("Satellites: ")); Serial.println(lastFix.satellites);
+  Serial.print(F("HDOP: ")); RecordFormatter_PrintFixed(Serial, lastFix.hdop, 2); Serial.println();
+  Serial.print(F("Caracteres: ")); Serial.println(gps.charsProcessed());
+  Serial.print(F("Trames OK: ")); Serial.println(gps.passedChecksum());
+  Serial.print(F("Erreurs checksum: ")); Serial.println(gps.failedChecksum());
+  Serial.print(F("Debordements: ")); Serial.println(gpsOverflows);
+  Serial.print(F("Veille: ")); Serial.println(gpsStandby ? F("oui") : F("non"));
+  Serial.println(F("==========="));
+}
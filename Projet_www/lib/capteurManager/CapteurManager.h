@@ -3,33 +3,35 @@
 
 #include <Arduino.h>
 
-// --- Structure des données capteurs ---
+// --- Structure des données capteurs (virgule fixe, 9 octets) ---
 struct SensorData {
-  float temperature;
-  float humidity;
-  float pressure;
-  int luminosity;
-  bool tempError;
-  bool hygrError;
-  bool pressError;
-  bool luminError;
+  int16_t  temperature;     // centiemes de °C
+  uint16_t humidity;        // centiemes de %RH
+  uint16_t pressure;        // dixiemes de hPa
+  uint16_t luminosity;      // 0..1023
+  uint8_t  tempError  : 1;
+  uint8_t  hygrError  : 1;
+  uint8_t  pressError : 1;
+  uint8_t  luminError : 1;
 };
 
-// --- Structure des paramètres ---
-struct SensorParams {
-  bool tempCheck; float MIN_TEMP_AIR; float MAX_TEMP_AIR;
-  bool hygrCheck; float HYGR_MINT; float HYGR_MAXT;
-  bool pressCheck; float PRESSURE_MIN; float PRESSURE_MAX;
-  bool luminCheck; int LUMIN_LOW; int LUMIN_HIGH;
-};
+// --- GPS ---
+#ifndef GPS_BYTES_PER_UPDATE
+#define GPS_BYTES_PER_UPDATE 64         // octets NMEA traites par passage dans loop()
+#endif
+#ifndef GPS_MAX_FIX_AGE_MS
+#define GPS_MAX_FIX_AGE_MS 120000UL     // au-dela, la position en cache est perimee
+#endif
 
 // --- Déclarations des fonctions ---
 bool init_capteur();
 SensorData readSensors();
-bool readGPS(float& lat, float& lon);
+bool readGPS(int32_t& lat, int32_t& lon);   // millioniemes de degre, depuis le cache
+void CapteurManager_UpdateGPS();
+void CapteurManager_PrintGPSStats();
+void CapteurManager_GPSStandby(bool standby);
 
 // --- Variables globales externes ---
-extern SensorParams sensorParams;
 extern bool bmeOK;
 
-#endif // CAPTEURMANAGER_H
\ No newline at end of file
+#endif // CAPTEURMANAGER_H
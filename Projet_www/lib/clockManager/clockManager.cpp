@@ -1,9 +1,203 @@
 #include "DS1307.h"
 #include <Arduino.h>
+#include <ConfigManager.h>
+#include <ErrorJournal.h>
+#include "clockManager.h"
 
 DS1307 clock;
 
-void init_clock(){clock.begin();Serial.println(F("[INFO] ClockManager initialisé"));}
+// --- Horloge logicielle ---
+// Secondes depuis le 2000-01-01 00:00:00, incrementees par Timer1 (Clock_Tick)
+// et recalees sur le DS1307 toutes les CLOCK_SYNC minutes : lire l'heure ne
+// coute plus d'echange I2C. Un recalage ne fait pas reculer l'heure (ordre
+// des journaux et de leur index) : en avance de moins de CLOCK_HOLD_MAX_S,
+// l'horloge s'arrete le temps que l'heure de reference la rattrape. Au-dela,
+// elle recule et le journal passe a une nouvelle revision (Clock_StepBacks).
+static volatile uint32_t epoch = 0;
+static volatile uint32_t holdSeconds = 0;   // ticks Timer1 a sauter
+static uint8_t stepBacks = 0;
+static uint32_t lastSync = 0;
+static uint32_t syncPeriod = 3600;
+static int32_t utcOffset = 0;          // secondes, heure locale - UTC
+static uint8_t configVersion = 0;
+
+// --- Suivi de la derive (RTC - horloge logicielle, en secondes) ---
+static uint16_t syncCount = 0;
+static uint16_t syncErrors = 0;
+static int32_t lastDrift = 0;
+static int32_t totalDrift = 0;
+
+// --- Corrections depuis le GPS ---
+static uint16_t gpsCorrections = 0;
+static int32_t lastGpsOffset = 0;
+static unsigned long lastGpsCorrection = 0;   // millis()
+
+// --- Date du jour, recalculee seulement au changement de jour ---
+static uint16_t cachedDay = 0xFFFF;
+static char cachedDate[7];
+static uint8_t cachedMonth = 1, cachedDayOfMonth = 1;
+static uint16_t cachedYear = 2000;
+
+static const uint16_t joursAvantMois[12] PROGMEM = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+static uint32_t toEpoch(uint8_t an, uint8_t mois, uint8_t jour, uint8_t h, uint8_t m, uint8_t s) {
+  uint32_t jours = an * 365UL + (an + 3) / 4 + pgm_read_word(&joursAvantMois[mois - 1]) + jour - 1;
+  if (mois > 2 && an % 4 == 0) jours++;
+  return ((jours * 24 + h) * 60 + m) * 60 + s;
+}
+
+uint32_t Clock_ToEpoch(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second) {
+  return toEpoch(year % 100, month, day, hour, minute, second);
+}
+
+// --- Jours depuis le 2000-01-01 -> date (2000-2099) ---
+static void dayToDate(uint16_t jours, uint16_t &year, uint8_t &month, uint8_t &day) {
+  uint8_t an = 0;
+  while (jours >= (an % 4 == 0 ? 366 : 365)) {
+    jours -= (an % 4 == 0 ? 366 : 365);
+    an++;
+  }
+  uint8_t mois = 12;
+  uint16_t debut;
+  do {
+    mois--;
+    debut = pgm_read_word(&joursAvantMois[mois]) + (mois >= 2 && an % 4 == 0);
+  } while (jours < debut);
+
+  year = 2000 + an;
+  month = mois + 1;
+  day = jours - debut + 1;
+}
+
+static uint32_t now() {
+  noInterrupts();
+  uint32_t t = epoch;
+  interrupts();
+  return t;
+}
+
+// Heure de reference suivie : epoch moins la retenue en cours
+static uint32_t target() {
+  noInterrupts();
+  uint32_t t = epoch - holdSeconds;
+  interrupts();
+  return t;
+}
+
+static void setEpoch(uint32_t t) {
+  noInterrupts();
+  if ((int32_t)(t - epoch) < 0) stepBacks++;
+  epoch = t;
+  holdSeconds = 0;
+  interrupts();
+}
+
+// --- Recalage sans retour en arriere, sauf au-dela de CLOCK_HOLD_MAX_S ---
+static void adjustEpoch(uint32_t t) {
+  noInterrupts();
+  uint32_t ahead = epoch - t;
+  if ((int32_t)ahead > 0 && ahead <= CLOCK_HOLD_MAX_S) holdSeconds = ahead;
+  else {
+    if ((int32_t)ahead > 0) stepBacks++;
+    epoch = t;
+    holdSeconds = 0;
+  }
+  interrupts();
+}
+
+uint8_t Clock_StepBacks() {
+  return stepBacks;
+}
+
+// --- Lecture du DS1307, rejetee si un champ est incoherent (bus I2C en defaut) ---
+static bool readRtc(uint32_t &t) {
+  clock.getTime();
+  uint8_t an = clock.year % 100;
+  if (clock.month < 1 || clock.month > 12 || clock.dayOfMonth < 1 || clock.dayOfMonth > 31 ||
+      clock.hour > 23 || clock.minute > 59 || clock.second > 59) return false;
+  t = toEpoch(an, clock.month, clock.dayOfMonth, clock.hour, clock.minute, clock.second);
+  return true;
+}
+
+void init_clock() {
+  clock.begin();
+  Clock_Sync();
+  Serial.println(F("[INFO] ClockManager initialisé"));
+}
+
+// --- Appele depuis l'ISR Timer1, une fois par seconde ---
+void Clock_Tick() {
+  if (holdSeconds) holdSeconds--;
+  else epoch++;
+}
+
+bool Clock_Sync() {
+  uint32_t rtc;
+  if (!readRtc(rtc)) {
+    syncErrors++;
+    lastSync = now();   // nouvel essai a la prochaine periode
+    ErrorJournal_Report(ERROR_RTC_ACCESS);
+    return false;
+  }
+
+  // La phase de Timer1 n'est pas alignee sur la seconde du DS1307 : un ecart de
+  // +-1 s n'est pas une derive et n'est pas corrige. Seules la premiere lecture
+  // (demarrage) et une avance de plus de CLOCK_HOLD_MAX_S font reculer l'heure.
+  int32_t drift = (int32_t)(rtc - target());
+  if (syncCount == 0) setEpoch(rtc);
+  else if (drift > 1 || drift < -1) adjustEpoch(rtc);
+  if (syncCount > 0) {
+    lastDrift = drift;
+    totalDrift += drift;
+  }
+  syncCount++;
+  lastSync = now();   // horloge retenue : pas de nouveau recalage avant la fin de la retenue
+  return true;
+}
+
+static void refreshConfig() {
+  if (configVersion == ConfigManager_Version()) return;
+  configVersion = ConfigManager_Version();
+  syncPeriod = configParams.CLOCK_SYNC * 60UL;
+  utcOffset = configParams.UTC_OFFSET * 60L;
+}
+
+void Clock_Update() {
+  refreshConfig();
+  if (now() - lastSync >= syncPeriod) Clock_Sync();
+}
+
+// --- Ecrit l'heure t dans le DS1307 et l'adopte (retenue ou recul, voir adjustEpoch) ---
+static void writeRtc(uint32_t t) {
+  uint16_t year;
+  uint8_t month, day;
+  dayToDate(t / 86400UL, year, month, day);
+  uint32_t s = t % 86400UL;
+  clock.fillByYMD(year, month, day);
+  clock.fillByHMS(s / 3600, s / 60 % 60, s % 60);
+  clock.setTime();
+  adjustEpoch(t);
+  lastSync = now();
+}
+
+// --- Correction automatique depuis le GPS, au-dela d'un seuil et rarement ---
+void Clock_DisciplineFromGps(uint32_t utc) {
+  refreshConfig();
+  uint32_t t = utc + utcOffset;
+  int32_t offset = (int32_t)(t - target());
+  if (offset < CLOCK_GPS_THRESHOLD_S && offset > -CLOCK_GPS_THRESHOLD_S) return;
+  if (gpsCorrections && millis() - lastGpsCorrection < CLOCK_GPS_MIN_INTERVAL_MS) return;
+
+  writeRtc(t);
+  gpsCorrections++;
+  lastGpsOffset = offset;
+  lastGpsCorrection = millis();
+
+  uint32_t ecart = offset < 0 ? -offset : offset;
+  ErrorJournal_Record(JOURNAL_CLOCK_GPS, ecart > 255 ? 255 : ecart);
+  Serial.print(F("[INFO] Horloge corrigee par le GPS: "));
+  Serial.print(offset); Serial.println(F(" s"));
+}
 
 void setupTime(
     uint16_t _year, 
@@ -15,18 +209,75 @@ void setupTime(
   clock.fillByYMD(_year, _month, _day);
   clock.fillByHMS(_hour, _minute, _second);
   clock.setTime();
+
+  uint32_t t = toEpoch(_year % 100, _month, _day, _hour, _minute, _second);
+  setEpoch(t);
+  lastSync = t;
+}
+
+// --- Secondes ecoulees depuis le 2000-01-01 00:00:00, temps constant ---
+uint32_t getTimestamp() {
+  return now();
+}
+
+uint16_t Clock_Day() {
+  return now() / 86400UL;
+}
+
+bool Clock_DateChanged(uint16_t &day) {
+  uint16_t today = Clock_Day();
+  if (today == day) return false;
+  day = today;
+  return true;
+}
+
+// --- AAMMJJ, nom du journal d'un jour ---
+static void formatAAMMJJ(char *date, uint16_t year, uint8_t month, uint8_t day) {
+  snprintf(date, 7, "%02u%02u%02u", year % 100, month % 100, day % 100);
+}
+
+static void updateDateCache() {
+  uint16_t day = Clock_Day();
+  if (day == cachedDay) return;
+  cachedDay = day;
+  dayToDate(day, cachedYear, cachedMonth, cachedDayOfMonth);
+  formatAAMMJJ(cachedDate, cachedYear, cachedMonth, cachedDayOfMonth);
+}
+
+void Clock_DayToAAMMJJ(uint16_t day, char *date) {
+  uint16_t year;
+  uint8_t month, dayOfMonth;
+  dayToDate(day, year, month, dayOfMonth);
+  formatAAMMJJ(date, year, month, dayOfMonth);
 }
 
 void getAAMMJJ(char *date) {
-  sprintf(date, "%02d%02d%02d", clock.year % 100, clock.month, clock.dayOfMonth);
+  updateDateCache();
+  strcpy(date, cachedDate);
 }
 
 void printTime() {
-  clock.getTime();
-  Serial.print(clock.hour, DEC); Serial.print(":");
-  Serial.print(clock.minute, DEC); Serial.print(":");
-  Serial.print(clock.second, DEC); Serial.print("  ");
-  Serial.print(clock.month, DEC); Serial.print("/");
-  Serial.print(clock.dayOfMonth, DEC); Serial.print("/");
-  Serial.print(clock.year + 2000, DEC); Serial.println("");
-}
\ No newline at end of file
+  updateDateCache();
+  uint32_t s = now() % 86400UL;
+  Serial.print(s / 3600, DEC); Serial.print(':');
+  Serial.print(s / 60 % 60, DEC); Serial.print(':');
+  Serial.print(s % 60, DEC); Serial.print(F("  "));
+  Serial.print(cachedMonth, DEC); Serial.print('/');
+  Serial.print(cachedDayOfMonth, DEC); Serial.print('/');
+  Serial.print(cachedYear, DEC); Serial.println();
+}
+
+void Clock_PrintStats() {
+  Serial.println(F("=== Horloge ==="));
+  Serial.print(F("Heure: ")); printTime();
+  Serial.print(F("Recalages: ")); Serial.println(syncCount);
+  Serial.print(F("Echecs RTC: ")); Serial.println(syncErrors);
+  Serial.print(F("Derive: ")); Serial.print(lastDrift); Serial.print(F(" s (cumul "));
+  Serial.print(totalDrift); Serial.println(F(" s)"));
+  Serial.print(F("Horloge retenue: ")); Serial.print(now() - target()); Serial.println(F(" s"));
+  Serial.print(F("Retours en arriere: ")); Serial.println(stepBacks);
+  Serial.print(F("Corrections GPS: ")); Serial.print(gpsCorrections);
+  Serial.print(F(" (dernier ecart ")); Serial.print(lastGpsOffset); Serial.println(F(" s)"));
+  Serial.print(F("Prochain recalage: ")); Serial.print((long)(syncPeriod - (now() - lastSync))); Serial.println(F(" s"));
+  Serial.println(F("==============="));
+}
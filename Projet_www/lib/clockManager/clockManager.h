@@ -15,6 +15,33 @@ void setupTime(
 
 void getAAMMJJ(char *date);
 
+uint32_t getTimestamp();
+
 void printTime();
 
+// --- Correction depuis l'heure GPS ---
+#ifndef CLOCK_GPS_THRESHOLD_S
+#define CLOCK_GPS_THRESHOLD_S 2             // ecart minimal corrige (latence NMEA ~1 s)
+#endif
+#ifndef CLOCK_GPS_MIN_INTERVAL_MS
+#define CLOCK_GPS_MIN_INTERVAL_MS 21600000UL  // au plus une correction toutes les 6 h
+#endif
+
+// --- Recalage vers l'arriere ---
+#ifndef CLOCK_HOLD_MAX_S
+#define CLOCK_HOLD_MAX_S 300                // au-dela, l'heure recule et le journal change de revision
+#endif
+
+// --- Horloge logicielle recalee sur le DS1307 ---
+void Clock_Tick();                       // ISR Timer1, 1 Hz
+void Clock_Update();                     // recalage periodique (CLOCK_SYNC minutes)
+bool Clock_Sync();
+uint16_t Clock_Day();                    // jours depuis le 2000-01-01
+bool Clock_DateChanged(uint16_t &day);   // true (et day mis a jour) si le jour a change
+void Clock_DayToAAMMJJ(uint16_t day, char *date);   // nom de fichier du journal de ce jour
+void Clock_DisciplineFromGps(uint32_t utc);   // heure UTC d'une trame GPS valide
+uint8_t Clock_StepBacks();               // change a chaque retour en arriere de l'heure
+uint32_t Clock_ToEpoch(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+void Clock_PrintStats();
+
 #endif // CLOCKMANAGER_H
@@ -2,40 +2,314 @@
 #include <EEPROM.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include <clockManager.h>
+#include <fileManager.h>
+#include <MemoryManager.h>
+#include <CapteurManager.h>
+#include <PowerManager.h>
+#include <Scheduler.h>
+#include <ConfigStore.h>
+#include <Crc16.h>
+#include <ErrorJournal.h>
 
+// Plus longue commande : "DUMP AAAA-MM-JJ-HH-MM-SS AAAA-MM-JJ-HH-MM-SS 1000000"
+// (52 caracteres) ; les lignes du provisionnement en bloc passent aussi ici
 #define CMD_BUFFER 64
 static char cmdBuffer[CMD_BUFFER];
+static uint8_t cmdLen = 0;           // longueur suivie : pas de strlen par caractere
+static bool cmdOverflow = false;
+static bool configMode = false;      // commandes d'ecriture autorisees
 unsigned int secondesEcoulees = 0;
 unsigned long TEMP_RETOUR_AUTO = 60  /*Secondes*/;
 
-Parametres params;
-
-// --- Valeurs par defaut en memoire flash ---
-const Parametres defaultParams PROGMEM = {
-  10, //LOG_INTERVAL
-  4096, //FILE_MAX_SIZE
-  30, //TIMEOUT
-  1, //LUMIN
-  255, //LUMIN_LOW
-  768, //LUMIN_HIGH
-  1, //TEMP_AIR
-  -10, //MIN_TEMP_AIR
-  60, //MAX_TEMP_AIR
-  1, //HYGR
-  0, //HYGR_MINT
-  50, //HYGR_MAXT
-  1, //PRESSURE
-  850, //PRESSURE_MIN
-  1080 //PRESSURE_MAX
+// --- Configuration unique, partagee par tous les modules ---
+Parametres configParams;
+static uint8_t configVersion = 0;   // incremente a chaque modification
+
+// --- Registre des parametres en memoire flash ---
+// Une entree par champ de Parametres : nom, position, type, bornes et valeur par
+// defaut. SET, GET, params, reset et la validation au chargement s'appuient
+// tous sur cette table.
+enum ParamType : uint8_t { PARAM_INT, PARAM_UINT };
+
+#define PARAM_NAME_MAX 14
+
+struct ParamDesc {
+  char name[PARAM_NAME_MAX];   // stocke dans l'entree : comparaison directe en flash
+  uint8_t offset;
+  uint8_t type;
+  long min, max, def;
 };
 
+#define PARAM(nom, type, min, max, def) { #nom, offsetof(Parametres, nom), type, min, max, def }
+
+// Triee par nom (ordre de strcasecmp) pour la recherche dichotomique
+static constexpr ParamDesc paramTable[] PROGMEM = {
+  PARAM(AGG_WINDOW,    PARAM_INT,  1,    60,    1),
+  PARAM(CLOCK_SYNC,    PARAM_INT,  1,    1440,  60),
+  PARAM(FILE_MAX_SIZE, PARAM_UINT, 512,  65535, 4096),
+  PARAM(HYGR,          PARAM_INT,  0,    1,     1),
+  PARAM(HYGR_MAXT,     PARAM_INT,  -40,  85,    50),
+  PARAM(HYGR_MINT,     PARAM_INT,  -40,  85,    0),
+  PARAM(LOG_INTERVAL,  PARAM_INT,  1,    3600,  10),
+  PARAM(LUMIN,         PARAM_INT,  0,    1,     1),
+  PARAM(LUMIN_HIGH,    PARAM_INT,  0,    1023,  768),
+  PARAM(LUMIN_LOW,     PARAM_INT,  0,    1023,  255),
+  PARAM(MAX_TEMP_AIR,  PARAM_INT,  -40,  85,    60),
+  PARAM(MIN_TEMP_AIR,  PARAM_INT,  -40,  85,    -10),
+  PARAM(PRESSURE,      PARAM_INT,  0,    1,     1),
+  PARAM(PRESSURE_MAX,  PARAM_INT,  300,  1100,  1080),
+  PARAM(PRESSURE_MIN,  PARAM_INT,  300,  1100,  850),
+  PARAM(STATION_ID,    PARAM_INT,  0,    32767, 1),
+  PARAM(TEMP_AIR,      PARAM_INT,  0,    1,     1),
+  PARAM(TIMEOUT,       PARAM_INT,  1,    600,   30),
+  PARAM(UTC_OFFSET,    PARAM_INT,  -720, 840,   0),
+};
+
+#define PARAM_COUNT (sizeof(paramTable) / sizeof(paramTable[0]))
+
+// --- Verifications a la compilation ---
+static constexpr char lowerChar(char c) { return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
+static constexpr int compareNames(const char *a, const char *b) {
+  return (lowerChar(*a) != lowerChar(*b) || !*a) ? lowerChar(*a) - lowerChar(*b) : compareNames(a + 1, b + 1);
+}
+static constexpr bool tableSorted(size_t i) {
+  return i + 1 >= PARAM_COUNT || (compareNames(paramTable[i].name, paramTable[i + 1].name) < 0 && tableSorted(i + 1));
+}
+static_assert(tableSorted(0), "paramTable doit etre triee par nom");
+static_assert(PARAM_COUNT * sizeof(int) == sizeof(Parametres), "chaque champ de Parametres doit figurer dans paramTable");
+
 // --- Declarations internes ---
 static void traiterCommande(char *cmd);
-void ConfigManager_save();
+static void printStatus();
+static bool storeParams(const Parametres &p);
+bool ConfigManager_save();
 void ConfigManager_load();
 void ConfigManager_reset();
 
+// --- Recherche dichotomique d'un parametre ; copie son entree en RAM ---
+static bool findParam(const char *name, ParamDesc &out) {
+  uint8_t lo = 0, hi = PARAM_COUNT;
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    int c = strcasecmp_P(name, paramTable[mid].name);
+    if (c == 0) {
+      memcpy_P(&out, &paramTable[mid], sizeof(out));
+      return true;
+    }
+    if (c < 0) hi = mid;
+    else lo = mid + 1;
+  }
+  return false;
+}
+
+static long getParam(const Parametres &p, const ParamDesc &d) {
+  const uint8_t *field = reinterpret_cast<const uint8_t*>(&p) + d.offset;
+  if (d.type == PARAM_UINT) return *reinterpret_cast<const unsigned int*>(field);
+  return *reinterpret_cast<const int*>(field);
+}
+
+static void setParam(Parametres &p, const ParamDesc &d, long value) {
+  uint8_t *field = reinterpret_cast<uint8_t*>(&p) + d.offset;
+  if (d.type == PARAM_UINT) *reinterpret_cast<unsigned int*>(field) = value;
+  else *reinterpret_cast<int*>(field) = value;
+}
+
+// --- Horloge : AAAA-MM-JJ-HH-MM-SS ---
+struct ClockSetting {
+  uint16_t year;
+  uint8_t month, day, hour, minute, second;
+};
+
+static bool parseClock(char *s, ClockSetting &c) {
+  char *t[6];
+  t[0] = strtok(s, "-");
+  for (uint8_t i = 1; i < 6; i++) t[i] = strtok(NULL, "-");
+  for (uint8_t i = 0; i < 6; i++) if (!t[i]) return false;
+
+  c.year = atoi(t[0]);
+  c.month = atoi(t[1]);
+  c.day = atoi(t[2]);
+  c.hour = atoi(t[3]);
+  c.minute = atoi(t[4]);
+  c.second = atoi(t[5]);
+  return c.year >= 2000 && c.year <= 2099 && c.month >= 1 && c.month <= 12 &&
+         c.day >= 1 && c.day <= 31 && c.hour < 24 && c.minute < 60 && c.second < 60;
+}
+
+// --- Instant : secondes depuis 2000-01-01, ou AAAA-MM-JJ-HH-MM-SS ---
+static bool parseTimestamp(char *s, uint32_t &t) {
+  if (strchr(s, '-')) {
+    ClockSetting c;
+    if (!parseClock(s, c)) return false;
+    t = Clock_ToEpoch(c.year, c.month, c.day, c.hour, c.minute, c.second);
+    return true;
+  }
+  char *end;
+  t = strtoul(s, &end, 10);
+  return end != s && !*end;
+}
+
+// --- DUMP <debut> <fin> [bauds] : journaux SD de la plage, au format texte ---
+// Envoi bloquant (une journee ~ 19 min a 9600 bauds) : mode configuration seulement,
+// ou l'acquisition est deja suspendue.
+static void dumpCommand(char *from, char *to, char *baudArg) {
+  uint32_t t0, t1;
+  unsigned long baud = CONSOLE_BAUD;
+  if (!from || !to || !parseTimestamp(from, t0) || !parseTimestamp(to, t1) || t1 < t0) {
+    Serial.println(F("[ERROR] Syntaxe: DUMP <debut> <fin> [bauds]"));
+    return;
+  }
+  if (baudArg) {
+    char *end;
+    baud = strtoul(baudArg, &end, 10);
+    if (end == baudArg || *end || baud < CONSOLE_BAUD || baud > DUMP_BAUD_MAX) {
+      Serial.println(F("[ERROR] Debit invalide !"));
+      return;
+    }
+  }
+
+  Serial.print(F("[INFO] DUMP a "));
+  Serial.print(baud);
+  Serial.println(F(" bauds"));
+  if (baud != CONSOLE_BAUD) {
+    Serial.flush();
+    Serial.begin(baud);
+    delay(DUMP_SWITCH_MS);
+  }
+
+  uint32_t n = FileManager_Dump(t0, t1, Serial);
+  Serial.print(F("END "));
+  Serial.println(n);
+
+  if (baud != CONSOLE_BAUD) {
+    Serial.flush();
+    Serial.begin(CONSOLE_BAUD);
+  }
+  // Le retour automatique compte depuis la fin de l'envoi
+  retourAutoFlag = false;
+}
+
+// --- Provisionnement en bloc ---
+// BEGIN <n>, puis n lignes NOM=valeur (CLOCK=AAAA-MM-JJ-HH-MM-SS accepte), puis
+// END <crc>, crc etant le CRC16 (hexa) des n lignes, '\n' compris. Les valeurs
+// sont preparees dans une copie, validees toutes, puis appliquees avec une seule
+// sauvegarde. Reponse : ACK, ou NAK <ligne> <raison> (ligne 0 : trame entiere).
+// Sans ligne recue pendant TIMEOUT secondes (NAK 0 delai) ou en sortie du mode
+// configuration (NAK 0 mode), le transfert est abandonne.
+static struct {
+  bool active;
+  unsigned long lastLine;            // millis() de BEGIN ou de la derniere ligne
+  uint8_t expected, received;
+  uint8_t errorLine;                 // 0 : pas d'erreur
+  const __FlashStringHelper *error;
+  uint16_t crc;
+  bool hasClock;
+  ClockSetting clock;
+  Parametres staged;
+} bulk;
+
+static void bulkReply(uint8_t line, const __FlashStringHelper *reason) {
+  if (!reason) {
+    Serial.println(F("ACK"));
+    return;
+  }
+  Serial.print(F("NAK ")); Serial.print(line);
+  Serial.print(' '); Serial.println(reason);
+}
+
+static void bulkBegin(const char *arg) {
+  long n = arg ? atol(arg) : 0;
+  if (n < 1 || n > (long)PARAM_COUNT + 1) {
+    bulkReply(0, F("syntaxe"));
+    return;
+  }
+  bulk.active = true;
+  bulk.lastLine = millis();
+  bulk.expected = n;
+  bulk.received = 0;
+  bulk.errorLine = 0;
+  bulk.crc = CRC16_INIT;
+  bulk.hasClock = false;
+  bulk.staged = configParams;
+}
+
+// Valide une ligne NOM=valeur dans la copie ; renvoie la raison d'un refus
+static const __FlashStringHelper *bulkApply(char *line) {
+  char *value = strchr(line, '=');
+  if (!value) return F("syntaxe");
+  *value++ = '\0';
+
+  if (!strcasecmp(line, "CLOCK")) {
+    if (!parseClock(value, bulk.clock)) return F("horloge");
+    bulk.hasClock = true;
+    return NULL;
+  }
+
+  ParamDesc d;
+  if (!findParam(line, d)) return F("parametre");
+  char *end;
+  long val = strtol(value, &end, 10);
+  if (end == value || *end) return F("valeur");
+  if (val < d.min || val > d.max) return F("limites");
+  setParam(bulk.staged, d, val);
+  return NULL;
+}
+
+static void bulkEnd(const char *arg) {
+  bulk.active = false;
+
+  char *end;
+  uint16_t crc = strtoul(arg, &end, 16);
+  if (end == arg) bulkReply(0, F("syntaxe"));
+  else if (bulk.received != bulk.expected) bulkReply(0, F("nombre"));
+  else if (crc != bulk.crc) bulkReply(0, F("crc"));
+  else if (bulk.errorLine) bulkReply(bulk.errorLine, bulk.error);
+  else
+  {
+    // Tout est valide : application atomique, rien n'est applique si l'EEPROM refuse
+    if (!storeParams(bulk.staged)) bulkReply(0, F("eeprom"));
+    else {
+      configParams = bulk.staged;
+      configVersion++;
+      if (bulk.hasClock) {
+        setupTime(bulk.clock.year, bulk.clock.month, bulk.clock.day,
+                  bulk.clock.hour, bulk.clock.minute, bulk.clock.second);
+      }
+      bulkReply(0, NULL);
+    }
+  }
+  Serial.print(F("> "));
+}
+
+static void bulkAbort(const __FlashStringHelper *reason) {
+  bulk.active = false;
+  cmdLen = 0;
+  cmdOverflow = false;
+  bulkReply(0, reason);
+  Serial.print(F("> "));
+}
+
+static void bulkLine(char *line) {
+  bulk.lastLine = millis();
+  if (!strncasecmp_P(line, PSTR("END"), 3) && (line[3] == ' ' || line[3] == '\0')) {
+    bulkEnd(line + 3);
+    return;
+  }
+
+  bulk.crc = Crc16_Compute(line, strlen(line), bulk.crc);
+  bulk.crc = Crc16_Update(bulk.crc, '\n');
+  if (bulk.received < 0xFF) bulk.received++;
+  if (bulk.received > bulk.expected || bulk.errorLine) return;
+
+  const __FlashStringHelper *err = bulkApply(line);
+  if (err) {
+    bulk.errorLine = bulk.received;
+    bulk.error = err;
+  }
+}
+
 // --- Initialisation ---
 void ConfigManager_init() {
   ConfigManager_load();
@@ -43,28 +317,46 @@ void ConfigManager_init() {
 }
 
 // --- Boucle principale ---
-void ConfigManager_Update() {
-  while (Serial.available()) {
+// Appelee dans tous les modes actifs, sans bloquer l'acquisition : au plus
+// CONSOLE_CHARS_PER_PASS caracteres lus et une seule commande executee par appel.
+void ConfigManager_Update(bool allowWrite) {
+  configMode = allowWrite;
+  if (bulk.active) {
+    if (!allowWrite) bulkAbort(F("mode"));
+    else if (millis() - bulk.lastLine >= (unsigned long)configParams.TIMEOUT * 1000UL) bulkAbort(F("delai"));
+  }
+
+  for (uint8_t n = 0; n < CONSOLE_CHARS_PER_PASS && Serial.available(); n++) {
     char c = Serial.read();
 
     if (c == '\r') continue;
 
-    if (c == '\n') {
-      traiterCommande(cmdBuffer);
-      Serial.print(F("> "));
-      cmdBuffer[0] = '\0';
-      secondesEcoulees = 0;
-    } else {
-      int len = strlen(cmdBuffer);
-      if (len < CMD_BUFFER - 1) {
-        cmdBuffer[len] = c;
-        cmdBuffer[len + 1] = '\0';
-        //Serial.print(c);
-      }
+    if (c != '\n') {
+      if (cmdLen < CMD_BUFFER - 1) cmdBuffer[cmdLen++] = c;
+      else cmdOverflow = true;
+      continue;
     }
-  }
 
+    cmdBuffer[cmdLen] = '\0';
+    // En bloc, une ligne tronquee est rejetee par le CRC
+    if (bulk.active) bulkLine(cmdBuffer);
+    else
+    {
+      if (cmdOverflow) Serial.println(F("[ERROR] Commande trop longue !"));
+      else traiterCommande(cmdBuffer);
+      if (!bulk.active) Serial.print(F("> "));
+    }
+    cmdLen = 0;
+    cmdOverflow = false;
+    secondesEcoulees = 0;
+    return;
+  }
+}
 
+static bool requireConfigMode() {
+  if (configMode) return true;
+  Serial.println(F("[ERROR] Commande disponible en mode configuration"));
+  return false;
 }
 
 // --- Commandes serie ---
@@ -80,45 +372,34 @@ static void traiterCommande(char *cmd) {
       Serial.println(F("[ERROR] Syntaxe: SET <param> <valeur>"));
       return;
     }
-    int val = atoi(arg3);
     bool ok = false;
+    ParamDesc d;
 
-    if (!strcasecmp(arg2, "LOG_INTERVAL")) { params.LOG_INTERVAL = val; ok = true; }
-    else if (!strcasecmp(arg2, "FILE_MAX_SIZE")) { params.FILE_MAX_SIZE = val; ok = true; }
-    else if (!strcasecmp(arg2, "TIMEOUT")) { params.TIMEOUT = val; ok = true; }
-    else if (!strcasecmp(arg2, "LUMIN")) { params.LUMIN = val; ok = true; }
-    else if (!strcasecmp(arg2, "LUMIN_LOW")) { params.LUMIN_LOW = val; ok = true; }
-    else if (!strcasecmp(arg2, "LUMIN_HIGH")) { params.LUMIN_HIGH = val; ok = true; }
-    else if (!strcasecmp(arg2, "TEMP_AIR")) { params.TEMP_AIR = val; ok = true; }
-    else if (!strcasecmp(arg2, "MIN_TEMP_AIR")) { params.MIN_TEMP_AIR = val; ok = true; }
-    else if (!strcasecmp(arg2, "MAX_TEMP_AIR")) { params.MAX_TEMP_AIR = val; ok = true; }
-    else if (!strcasecmp(arg2, "HYGR")) { params.HYGR = val; ok = true; }
-    else if (!strcasecmp(arg2, "HYGR_MINT")) { params.HYGR_MINT = val; ok = true; }
-    else if (!strcasecmp(arg2, "HYGR_MAXT")) { params.HYGR_MAXT = val; ok = true; }
-    else if (!strcasecmp(arg2, "PRESSURE")) { params.PRESSURE = val; ok = true; }
-    else if (!strcasecmp(arg2, "PRESSURE_MIN")) { params.PRESSURE_MIN = val; ok = true; }
-    else if (!strcasecmp(arg2, "PRESSURE_MAX")) { params.PRESSURE_MAX = val; ok = true; }
-    else if(!strcasecmp(arg2, "CLOCK"))
+    if (findParam(arg2, d)) {
+      char *end;
+      long val = strtol(arg3, &end, 10);
+      if (end == arg3 || *end) {
+        Serial.println(F("[ERROR] Valeur invalide !"));
+        return;
+      }
+      if (val < d.min || val > d.max) {
+        Serial.print(F("[ERROR] Valeur hors limites ("));
+        Serial.print(d.min); Serial.print(F(".."));
+        Serial.print(d.max); Serial.println(')');
+        return;
+      }
+      setParam(configParams, d, val);
+      ok = true;
+    }
+    else if (!strcasecmp(arg2, "CLOCK"))
     {
-      char *token1 = strtok(arg3,"-");
-      char *token2 = strtok(NULL,"-");
-      char *token3 = strtok(NULL,"-");
-      char *token4 = strtok(NULL,"-");
-      char *token5 = strtok(NULL,"-");
-      char *token6 = strtok(NULL,"-");
-      if(!token1 || !token2 || !token3 || !token4 || !token5 || !token6)
+      ClockSetting c;
+      if (!parseClock(arg3, c))
       {
         Serial.println(F("[ERROR] Syntaxe: SET CLOCK <YYYY-MM-DD-HH-MM-SS>"));
         return;
       }
-      setupTime(
-        atoi(token1),
-        atoi(token2),
-        atoi(token3),
-        atoi(token4),
-        atoi(token5),
-        atoi(token6)
-      );
+      setupTime(c.year, c.month, c.day, c.hour, c.minute, c.second);
 
       Serial.print(F("[INFO] Horloge mise à jour à :"));
       printTime();
@@ -138,28 +419,31 @@ static void traiterCommande(char *cmd) {
       return;
     }
 
-    if (!strcasecmp(arg2, "LOG_INTERVAL")) Serial.println(params.LOG_INTERVAL);
-    else if (!strcasecmp(arg2, "FILE_MAX_SIZE")) Serial.println(params.FILE_MAX_SIZE);
-    else if (!strcasecmp(arg2, "TIMEOUT")) Serial.println(params.TIMEOUT);
-    else if (!strcasecmp(arg2, "LUMIN")) Serial.println(params.LUMIN);
-    else if (!strcasecmp(arg2, "LUMIN_LOW")) Serial.println(params.LUMIN_LOW);
-    else if (!strcasecmp(arg2, "LUMIN_HIGH")) Serial.println(params.LUMIN_HIGH);
-    else if (!strcasecmp(arg2, "TEMP_AIR")) Serial.println(params.TEMP_AIR);
-    else if (!strcasecmp(arg2, "MIN_TEMP_AIR")) Serial.println(params.MIN_TEMP_AIR);
-    else if (!strcasecmp(arg2, "MAX_TEMP_AIR")) Serial.println(params.MAX_TEMP_AIR);
-    else if (!strcasecmp(arg2, "HYGR")) Serial.println(params.HYGR);
-    else if (!strcasecmp(arg2, "HYGR_MINT")) Serial.println(params.HYGR_MINT);
-    else if (!strcasecmp(arg2, "HYGR_MAXT")) Serial.println(params.HYGR_MAXT);
-    else if (!strcasecmp(arg2, "PRESSURE")) Serial.println(params.PRESSURE);
-    else if (!strcasecmp(arg2, "PRESSURE_MIN")) Serial.println(params.PRESSURE_MIN);
-    else if (!strcasecmp(arg2, "PRESSURE_MAX")) Serial.println(params.PRESSURE_MAX);
+    ParamDesc d;
+    if (findParam(arg2, d)) Serial.println(getParam(configParams, d));
     else Serial.println(F("[ERROR] Parametre inconnu !"));
   }
 
-  else if (!strcasecmp(arg1, "reset")) ConfigManager_reset();
+  else if (!strcasecmp(arg1, "begin")) { if (requireConfigMode()) bulkBegin(arg2); }
+  else if (!strcasecmp(arg1, "reset")) { if (requireConfigMode()) ConfigManager_reset(); }
+  else if (!strcasecmp(arg1, "status")) printStatus();
   else if (!strcasecmp(arg1, "version")) Serial.println(F("Version: 1.0"));
   else if (!strcasecmp(arg1, "params")) ConfigManager_printParams();
-    else if (!strcasecmp(arg1, "exit")) {
+  else if (!strcasecmp(arg1, "sd")) FileManager_PrintStats();
+  else if (!strcasecmp(arg1, "dump")) { if (requireConfigMode()) dumpCommand(arg2, arg3, strtok(NULL, " ")); }
+  else if (!strcasecmp(arg1, "mem")) MemoryManager_PrintStats();
+  else if (!strcasecmp(arg1, "gps")) CapteurManager_PrintGPSStats();
+  else if (!strcasecmp(arg1, "power")) PowerManager_PrintStats();
+  else if (!strcasecmp(arg1, "tasks")) Scheduler_PrintStats();
+  else if (!strcasecmp(arg1, "eeprom")) ConfigStore_PrintStats();
+  else if (!strcasecmp(arg1, "clock")) Clock_PrintStats();
+  else if (!strcasecmp(arg1, "errors")) {
+    if (!arg2) ErrorJournal_Dump();
+    else if (!strcasecmp(arg2, "clear")) { if (requireConfigMode()) ErrorJournal_Clear(); }
+    else Serial.println(F("[ERROR] Syntaxe: ERRORS [CLEAR]"));
+  }
+  else if (!strcasecmp(arg1, "exit")) {
+    if (!requireConfigMode()) return;
     retourAutoFlag = true;
     Serial.println(F("[INFO] Sortie immédiate du mode configuration..."));
   }
@@ -167,43 +451,115 @@ static void traiterCommande(char *cmd) {
 }
 
 // --- Fonctions memoire ---
-void ConfigManager_save() {
-  EEPROM.put(0, params);
-  Serial.println(F("[INFO] Parametres sauvegardes."));
+static bool storeParams(const Parametres &p) {
+  bool ok = ConfigStore_Save(&p, sizeof(p));
+  if (ok) Serial.println(F("[INFO] Parametres sauvegardes."));
+  else Serial.println(F("[ERROR] Echec d'ecriture en EEPROM"));
+  return ok;
 }
 
+bool ConfigManager_save() {
+  bool ok = storeParams(configParams);
+  configVersion++;
+  return ok;
+}
+
+static void applyDefaults(Parametres &p) {
+  ParamDesc d;
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    memcpy_P(&d, &paramTable[i], sizeof(d));
+    setParam(p, d, d.def);
+  }
+}
+
+// Taille de Parametres dans la premiere version du journal EEPROM
+#define PARAMETRES_V1_SIZE offsetof(Parametres, CLOCK_SYNC)
+
 void ConfigManager_load() {
-  EEPROM.get(0, params);
+  bool dirty = false;
+
+  // Journal ecrit par une version plus ancienne (structure plus courte) : les
+  // champs ajoutes prennent leur valeur par defaut (0xFFFF se lirait -1, une
+  // valeur dans les limites de UTC_OFFSET)
+  memset(&configParams, 0xFF, sizeof(configParams));
+  uint8_t size = sizeof(configParams);
+  bool loaded;
+  while (!(loaded = ConfigStore_Load(&configParams, size)) && size > PARAMETRES_V1_SIZE) size -= sizeof(int);
 
-  if (params.LOG_INTERVAL <= 0 || params.LOG_INTERVAL > 3600) {
-    memcpy_P(&params, &defaultParams, sizeof(Parametres));
-    ConfigManager_save();
+  if (!loaded) {
+    // Pas de journal valide : ancien format (structure brute en debut d'EEPROM),
+    // recopie dans le journal une fois validee
+    uint8_t *p = reinterpret_cast<uint8_t*>(&configParams);
+    for (uint8_t i = 0; i < PARAMETRES_V1_SIZE; i++) p[i] = EEPROM.read(i);
+    size = PARAMETRES_V1_SIZE;
+  }
+
+  ParamDesc d;
+  if (size < sizeof(configParams)) {
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+      memcpy_P(&d, &paramTable[i], sizeof(d));
+      if (d.offset >= size) setParam(configParams, d, d.def);
+    }
+    dirty = true;
   }
+
+  // EEPROM vierge ou illisible : valeurs par defaut
+  findParam("LOG_INTERVAL", d);
+  long interval = getParam(configParams, d);
+  if (interval < d.min || interval > d.max) {
+    applyDefaults(configParams);
+    dirty = true;
+  }
+  else
+  {
+    // Sinon, seuls les champs hors limites reprennent leur valeur par defaut
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+      memcpy_P(&d, &paramTable[i], sizeof(d));
+      long v = getParam(configParams, d);
+      if (v < d.min || v > d.max) {
+        setParam(configParams, d, d.def);
+        dirty = true;
+      }
+    }
+  }
+  if (dirty) ConfigManager_save();
+  else configVersion++;
   Serial.println(F("[INFO] Parametres charges depuis EEPROM."));
 }
 
 void ConfigManager_reset() {
-  memcpy_P(&params, &defaultParams, sizeof(Parametres));
+  applyDefaults(configParams);
   ConfigManager_save();
   Serial.println(F("[INFO] Reinitialisation terminee."));
 }
 
+static void printStatus() {
+  Serial.println(F("=== Etat ==="));
+  Serial.print(F("Mode: ")); Serial.println(configMode ? F("configuration") : F("acquisition"));
+  Serial.print(F("Uptime: ")); Serial.print(millis() / 1000); Serial.println(F(" s"));
+  Serial.print(F("Config: version ")); Serial.println(configVersion);
+  Serial.print(F("Horloge: ")); printTime();
+  Serial.println(F("============"));
+}
+
+static void printParam(const ParamDesc &d) {
+  Serial.print(d.name); Serial.print(F(": "));
+  Serial.print(getParam(configParams, d));
+  Serial.print(F(" ["));
+  Serial.print(d.min); Serial.print(F(".."));
+  Serial.print(d.max); Serial.println(']');
+}
+
 void ConfigManager_printParams() {
   Serial.println(F("=== Parametres actuels ==="));
-  Serial.print(F("LOG_INTERVAL: ")); Serial.println(params.LOG_INTERVAL);
-  Serial.print(F("FILE_MAX_SIZE: ")); Serial.println(params.FILE_MAX_SIZE);
-  Serial.print(F("TIMEOUT: ")); Serial.println(params.TIMEOUT);
-  Serial.print(F("LUMIN: ")); Serial.println(params.LUMIN);
-  Serial.print(F("LUMIN_LOW: ")); Serial.println(params.LUMIN_LOW);
-  Serial.print(F("LUMIN_HIGH: ")); Serial.println(params.LUMIN_HIGH);
-  Serial.print(F("TEMP_AIR: ")); Serial.println(params.TEMP_AIR);
-  Serial.print(F("MIN_TEMP_AIR: ")); Serial.println(params.MIN_TEMP_AIR);
-  Serial.print(F("MAX_TEMP_AIR: ")); Serial.println(params.MAX_TEMP_AIR);
-  Serial.print(F("HYGR: ")); Serial.println(params.HYGR);
-  Serial.print(F("HYGR_MINT: ")); Serial.println(params.HYGR_MINT);
-  Serial.print(F("HYGR_MAXT: ")); Serial.println(params.HYGR_MAXT);
-  Serial.print(F("PRESSURE: ")); Serial.println(params.PRESSURE);
-  Serial.print(F("PRESSURE_MIN: ")); Serial.println(params.PRESSURE_MIN);
-  Serial.print(F("PRESSURE_MAX: ")); Serial.println(params.PRESSURE_MAX);
+  ParamDesc d;
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    memcpy_P(&d, &paramTable[i], sizeof(d));
+    printParam(d);
+  }
   Serial.println(F("=========================="));
 }
+
+uint8_t ConfigManager_Version() {
+  return configVersion;
+}
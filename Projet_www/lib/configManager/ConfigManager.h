@@ -4,6 +4,14 @@
 #include <Arduino.h>
 #include <avr/pgmspace.h>
 
+// --- Console serie ---
+#define CONSOLE_BAUD 9600
+#define DUMP_BAUD_MAX 1000000UL     // 16 MHz : 250000, 500000 et 1000000 sans erreur de debit
+#define DUMP_SWITCH_MS 100          // pause apres changement de debit, le temps que le PC suive
+#ifndef CONSOLE_CHARS_PER_PASS
+#define CONSOLE_CHARS_PER_PASS 24   // 24 car. / 20 ms > 9600 bauds
+#endif
+
 // --- Structure des paramètres ---
 typedef struct {
   int LOG_INTERVAL;
@@ -25,6 +33,13 @@ typedef struct {
   int PRESSURE;
   int PRESSURE_MIN;
   int PRESSURE_MAX;
+
+  int STATION_ID;
+
+  // Champs ajoutes apres la premiere version du journal EEPROM : toujours a la fin
+  int CLOCK_SYNC;
+  int UTC_OFFSET;
+  int AGG_WINDOW;       // acquisitions par enregistrement SD (1 = pas d'agregation)
 } Parametres;
 
 extern unsigned long TEMP_RETOUR_AUTO ;
@@ -33,15 +48,18 @@ extern volatile bool retourAutoFlag;
 
 
 // --- Déclaration de la variable globale ---
+// Chargee une seule fois depuis l'EEPROM par ConfigManager_init(). Les modules
+// qui en derivent des valeurs les recalculent quand ConfigManager_Version() change.
 extern Parametres configParams;
 
 // --- Fonctions publiques ---
 void ConfigManager_init();
 void ConfigManager_loop();
-void ConfigManager_save();
-void ConfigManager_Update();
+bool ConfigManager_save();
+void ConfigManager_Update(bool configMode);   // hors configuration : lecture et SET seulement
 void ConfigManager_reset();
 void ConfigManager_printParams();
+uint8_t ConfigManager_Version();
 
 
 
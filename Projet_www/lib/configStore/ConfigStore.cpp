@@ -0,0 +1,142 @@
+// Journal de configuration en EEPROM.
+//
+// La zone est decoupee en emplacements [seq | crc | donnees] utilises tour a
+// tour : chaque sauvegarde ecrit l'emplacement suivant, ce qui repartit l'usure
+// sur toute la zone. Le CRC couvre la taille, le numero de sequence et les
+// donnees ; un emplacement coupe en cours d'ecriture est donc ignore et le
+// precedent, intact, reste utilise.
+
+#include "ConfigStore.h"
+#include <EEPROM.h>
+#include <Crc16.h>
+
+struct SlotHeader {
+  uint16_t seq;
+  uint16_t crc;
+};
+
+#define SEQ_ERASED 0xFFFF
+
+static uint8_t activeSlot = 0xFF;     // 0xFF : aucun emplacement valide
+static uint8_t activeSize = 0;        // taille des donnees, fixe le decoupage en emplacements
+static uint16_t activeSeq = 0;
+static uint16_t saveCount = 0;        // depuis le demarrage
+static uint16_t skippedCount = 0;     // sauvegardes inutiles (donnees identiques)
+
+static uint16_t slotSize(uint8_t size) { return sizeof(SlotHeader) + size; }
+static uint8_t slotCount(uint8_t size) { return CONFIG_STORE_SIZE / slotSize(size); }
+static int slotAddress(uint8_t slot, uint8_t size) { return CONFIG_STORE_START + slot * slotSize(size); }
+
+// Comparaison modulo 2^16 : les sequences presentes ne s'ecartent que de slotCount()
+static bool seqNewer(uint16_t a, uint16_t b) { return (int16_t)(a - b) > 0; }
+
+static uint16_t slotCrc(uint8_t slot, uint8_t size, uint16_t seq) {
+  // La taille entre dans le CRC : un changement de Parametres invalide les anciens emplacements
+  uint16_t crc = Crc16_Update(CRC16_INIT, size);
+  crc = Crc16_Compute(&seq, sizeof(seq), crc);
+  int addr = slotAddress(slot, size) + sizeof(SlotHeader);
+  for (uint8_t i = 0; i < size; i++) crc = Crc16_Update(crc, EEPROM.read(addr + i));
+  return crc;
+}
+
+static bool slotValid(uint8_t slot, uint8_t size, SlotHeader &h) {
+  EEPROM.get(slotAddress(slot, size), h);
+  return h.seq != SEQ_ERASED && h.crc == slotCrc(slot, size, h.seq);
+}
+
+bool ConfigStore_Load(void *data, uint8_t size) {
+  uint8_t count = slotCount(size);
+  activeSlot = 0xFF;
+
+  // Premier passage : seulement les numeros de sequence, le plus recent gagne
+  uint8_t newest = 0xFF;
+  uint16_t newestSeq = 0;
+  for (uint8_t s = 0; s < count; s++) {
+    uint16_t seq;
+    EEPROM.get(slotAddress(s, size), seq);
+    if (seq == SEQ_ERASED) continue;
+    if (newest == 0xFF || seqNewer(seq, newestSeq)) {
+      newest = s;
+      newestSeq = seq;
+    }
+  }
+  if (newest == 0xFF) return false;
+
+  // Les ecritures avancent d'un emplacement a la fois : si le plus recent est
+  // corrompu (coupure), on recule vers le precedent.
+  for (uint8_t n = 0; n < count; n++) {
+    uint8_t s = (newest + count - n) % count;
+    SlotHeader h;
+    if (!slotValid(s, size, h)) continue;
+    activeSlot = s;
+    activeSize = size;
+    activeSeq = h.seq;
+    int addr = slotAddress(s, size) + sizeof(SlotHeader);
+    uint8_t *p = (uint8_t*)data;
+    for (uint8_t i = 0; i < size; i++) p[i] = EEPROM.read(addr + i);
+    return true;
+  }
+  return false;
+}
+
+bool ConfigStore_Save(const void *data, uint8_t size) {
+  const uint8_t *p = (const uint8_t*)data;
+  uint8_t count = slotCount(size);
+
+  // Donnees relues avec une autre taille (structure agrandie) : on repart du
+  // premier emplacement, la sequence continue
+  if (activeSize != size) activeSlot = 0xFF;
+
+  // Rien n'a change : pas d'ecriture
+  if (activeSlot != 0xFF) {
+    int addr = slotAddress(activeSlot, size) + sizeof(SlotHeader);
+    uint8_t i = 0;
+    while (i < size && EEPROM.read(addr + i) == p[i]) i++;
+    if (i == size) {
+      skippedCount++;
+      return true;
+    }
+  }
+
+  uint8_t slot = (activeSlot == 0xFF) ? count - 1 : activeSlot;
+  uint16_t seq = activeSeq;
+
+  // Un emplacement use (relecture fausse) est saute au profit du suivant
+  for (uint8_t attempt = 0; attempt < count; attempt++) {
+    slot = (slot + 1) % count;
+    if (++seq == SEQ_ERASED) seq = 0;
+
+    // Donnees d'abord, en-tete ensuite : tant que l'en-tete n'est pas ecrit, le
+    // CRC de l'emplacement ne correspond pas et le precedent reste le plus recent.
+    // EEPROM.update() n'ecrit que les octets qui changent.
+    int addr = slotAddress(slot, size);
+    for (uint8_t i = 0; i < size; i++) EEPROM.update(addr + sizeof(SlotHeader) + i, p[i]);
+
+    SlotHeader h;
+    h.seq = seq;
+    h.crc = slotCrc(slot, size, seq);
+    const uint8_t *hp = (const uint8_t*)&h;
+    for (uint8_t i = 0; i < sizeof(h); i++) EEPROM.update(addr + i, hp[i]);
+
+    SlotHeader check;
+    if (slotValid(slot, size, check) && check.seq == seq) {
+      activeSlot = slot;
+      activeSize = size;
+      activeSeq = seq;
+      saveCount++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ConfigStore_PrintStats() {
+  Serial.println(F("=== Journal EEPROM ==="));
+  Serial.print(F("Emplacement: "));
+  if (activeSlot == 0xFF) Serial.println('-');
+  else Serial.println(activeSlot);
+  Serial.print(F("Sequence: ")); Serial.println(activeSeq);
+  Serial.print(F("Sauvegardes: ")); Serial.println(saveCount);
+  Serial.print(F("Inchangees: ")); Serial.println(skippedCount);
+  Serial.println(F("======================"));
+}
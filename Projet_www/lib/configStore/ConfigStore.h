@@ -0,0 +1,21 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+
+// --- Zone EEPROM reservee au journal de configuration ---
+// Le reste de l'EEPROM (a partir de CONFIG_STORE_START + CONFIG_STORE_SIZE)
+// est libre pour d'autres modules.
+#ifndef CONFIG_STORE_START
+#define CONFIG_STORE_START 0
+#endif
+#ifndef CONFIG_STORE_SIZE
+#define CONFIG_STORE_SIZE 768
+#endif
+
+// --- Fonctions publiques ---
+bool ConfigStore_Load(void *data, uint8_t size);         // false : aucun emplacement valide de cette taille
+bool ConfigStore_Save(const void *data, uint8_t size);
+void ConfigStore_PrintStats();
+
+#endif // CONFIG_STORE_H
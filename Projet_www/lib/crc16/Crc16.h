@@ -0,0 +1,25 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+// CRC-16/CCITT-FALSE (polynome 0x1021, valeur initiale 0xFFFF).
+// Ce fichier ne depend pas d'Arduino : le firmware et les outils PC
+// calculent le meme CRC.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRC16_INIT 0xFFFF
+
+static inline uint16_t Crc16_Update(uint16_t crc, uint8_t b) {
+  crc ^= (uint16_t)b << 8;
+  for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  return crc;
+}
+
+static inline uint16_t Crc16_Compute(const void *data, size_t len, uint16_t crc = CRC16_INIT) {
+  const uint8_t *p = (const uint8_t*)data;
+  while (len--) crc = Crc16_Update(crc, *p++);
+  return crc;
+}
+
+#endif // CRC16_H
@@ -0,0 +1,162 @@
+// Journal des erreurs.
+//
+// ErrorJournal_Record() ne fait que compter et deposer l'evenement dans une
+// petite file en RAM : il peut etre appele depuis le chemin d'acquisition.
+// ErrorJournal_Update() recopie ensuite les evenements dans un anneau en EEPROM
+// (un par appel) et sauvegarde les compteurs au plus toutes les
+// ERROR_JOURNAL_SAVE_MS, pour menager les cellules.
+//
+// Zone EEPROM : [magic | compteurs par code] puis l'anneau d'evenements. Un
+// emplacement vierge a code 0xFF ; le plus recent est celui de plus grand
+// horodatage, l'indice d'ecriture n'est donc jamais stocke.
+
+#include "ErrorJournal.h"
+#include <EEPROM.h>
+#include <clockManager.h>
+#include <stddef.h>
+
+#define JOURNAL_MAGIC 0x4A45                 // "EJ"
+#define EVENT_EMPTY 0xFF
+
+struct __attribute__((packed)) JournalHeader {
+  uint16_t magic;
+  uint16_t counters[ERROR_COUNT];
+};
+
+#define EVENTS_START (ERROR_JOURNAL_START + sizeof(JournalHeader))
+#define EVENT_SLOTS ((ERROR_JOURNAL_SIZE - sizeof(JournalHeader)) / sizeof(ErrorEvent))
+
+static_assert((ERROR_JOURNAL_PENDING & (ERROR_JOURNAL_PENDING - 1)) == 0, "ERROR_JOURNAL_PENDING doit etre une puissance de 2");
+
+static const char name0[] PROGMEM = "RTC";
+static const char name1[] PROGMEM = "GPS";
+static const char name2[] PROGMEM = "CAPTEUR";
+static const char name3[] PROGMEM = "INCOHERENT";
+static const char name4[] PROGMEM = "SD_PLEINE";
+static const char name5[] PROGMEM = "SD_ACCES";
+static const char name6[] PROGMEM = "HORLOGE_GPS";
+static const char *const codeNames[JOURNAL_CODE_COUNT] PROGMEM = { name0, name1, name2, name3, name4, name5, name6 };
+
+// --- Etat en RAM ---
+static uint16_t counters[ERROR_COUNT];
+static bool countersDirty = false;
+static unsigned long countersSavedAt = 0;
+static uint16_t lostEvents = 0;             // file pleine
+
+static ErrorEvent pending[ERROR_JOURNAL_PENDING];
+static uint8_t pendingHead = 0, pendingTail = 0;
+static uint8_t nextSlot = 0;                // prochain emplacement de l'anneau EEPROM
+
+static ErrorEvent lastEvent = { 0, EVENT_EMPTY, 0 };
+
+static int slotAddress(uint8_t slot) { return EVENTS_START + slot * sizeof(ErrorEvent); }
+
+void ErrorJournal_Init() {
+  JournalHeader h;
+  EEPROM.get(ERROR_JOURNAL_START, h);
+  if (h.magic != JOURNAL_MAGIC) {
+    ErrorJournal_Clear();
+    Serial.println(F("[INFO] ErrorJournal initialisé"));
+    return;
+  }
+  memcpy(counters, h.counters, sizeof(counters));
+
+  // L'emplacement suivant le plus recent recoit le prochain evenement
+  uint32_t newest = 0;
+  bool found = false;
+  for (uint8_t s = 0; s < EVENT_SLOTS; s++) {
+    ErrorEvent e;
+    EEPROM.get(slotAddress(s), e);
+    if (e.code == EVENT_EMPTY) {
+      if (!found) nextSlot = s;
+      break;
+    }
+    if (!found || e.time >= newest) {
+      newest = e.time;
+      nextSlot = (s + 1) % EVENT_SLOTS;
+      found = true;
+    }
+  }
+  Serial.println(F("[INFO] ErrorJournal initialisé"));
+}
+
+void ErrorJournal_Record(uint8_t code, uint8_t context) {
+  if (code >= JOURNAL_CODE_COUNT) return;
+  if (code < ERROR_COUNT) {
+    if (counters[code] < 0xFFFF) counters[code]++;
+    countersDirty = true;
+  }
+
+  uint32_t now = getTimestamp();
+  // Une erreur qui se repete a chaque mesure ne remplit pas l'anneau
+  if (code == lastEvent.code && context == lastEvent.context && now - lastEvent.time < ERROR_JOURNAL_REPEAT_S) return;
+  lastEvent.time = now;
+  lastEvent.code = code;
+  lastEvent.context = context;
+
+  uint8_t next = (pendingHead + 1) & (ERROR_JOURNAL_PENDING - 1);
+  if (next == pendingTail) {
+    lostEvents++;
+    return;
+  }
+  pending[pendingHead] = lastEvent;
+  pendingHead = next;
+}
+
+void ErrorJournal_Report(ErrorCode code, uint8_t context) {
+  ErrorJournal_Record(code, context);
+  LedManager_Feedback(code);
+}
+
+static void saveCounters() {
+  JournalHeader h;
+  h.magic = JOURNAL_MAGIC;
+  memcpy(h.counters, counters, sizeof(counters));
+  const uint8_t *p = (const uint8_t*)&h;
+  for (uint8_t i = 0; i < sizeof(h); i++) EEPROM.update(ERROR_JOURNAL_START + i, p[i]);
+  countersDirty = false;
+  countersSavedAt = millis();
+}
+
+void ErrorJournal_Update() {
+  // Un evenement par appel : chaque octet EEPROM bloque ~3,3 ms
+  if (pendingTail != pendingHead) {
+    EEPROM.put(slotAddress(nextSlot), pending[pendingTail]);
+    nextSlot = (nextSlot + 1) % EVENT_SLOTS;
+    pendingTail = (pendingTail + 1) & (ERROR_JOURNAL_PENDING - 1);
+    return;
+  }
+  if (countersDirty && millis() - countersSavedAt >= ERROR_JOURNAL_SAVE_MS) saveCounters();
+}
+
+void ErrorJournal_Dump() {
+  Serial.println(F("=== Journal des erreurs ==="));
+  for (uint8_t c = 0; c < ERROR_COUNT; c++) {
+    Serial.print(reinterpret_cast<const __FlashStringHelper*>(pgm_read_ptr(&codeNames[c])));
+    Serial.print(F(": ")); Serial.println(counters[c]);
+  }
+  if (lostEvents) { Serial.print(F("Perdus: ")); Serial.println(lostEvents); }
+
+  // Du plus ancien au plus recent (les evenements encore en RAM ne sont pas listes)
+  for (uint8_t n = 0; n < EVENT_SLOTS; n++) {
+    uint8_t s = (nextSlot + n) % EVENT_SLOTS;
+    ErrorEvent e;
+    EEPROM.get(slotAddress(s), e);
+    if (e.code >= JOURNAL_CODE_COUNT) continue;
+    Serial.print(e.time); Serial.print(' ');
+    Serial.print(reinterpret_cast<const __FlashStringHelper*>(pgm_read_ptr(&codeNames[e.code])));
+    Serial.print(F(" ctx=")); Serial.println(e.context);
+  }
+  Serial.println(F("==========================="));
+}
+
+void ErrorJournal_Clear() {
+  memset(counters, 0, sizeof(counters));
+  lostEvents = 0;
+  pendingHead = pendingTail = 0;
+  nextSlot = 0;
+  lastEvent.code = EVENT_EMPTY;
+  for (uint8_t s = 0; s < EVENT_SLOTS; s++) EEPROM.update(slotAddress(s) + offsetof(ErrorEvent, code), EVENT_EMPTY);
+  saveCounters();
+  Serial.println(F("[INFO] Journal des erreurs efface"));
+}
@@ -0,0 +1,44 @@
+#ifndef ERROR_JOURNAL_H
+#define ERROR_JOURNAL_H
+
+#include <Arduino.h>
+#include <LedManager.h>
+#include <ConfigStore.h>
+
+// --- Zone EEPROM du journal, a la suite du journal de configuration ---
+#define ERROR_JOURNAL_START (CONFIG_STORE_START + CONFIG_STORE_SIZE)
+#ifndef ERROR_JOURNAL_SIZE
+#define ERROR_JOURNAL_SIZE 256
+#endif
+
+#ifndef ERROR_JOURNAL_PENDING
+#define ERROR_JOURNAL_PENDING 4              // evenements en RAM en attente d'ecriture
+#endif
+#ifndef ERROR_JOURNAL_SAVE_MS
+#define ERROR_JOURNAL_SAVE_MS 600000UL       // ecriture des compteurs au plus toutes les 10 min
+#endif
+#ifndef ERROR_JOURNAL_REPEAT_S
+#define ERROR_JOURNAL_REPEAT_S 60            // une erreur identique dans ce delai n'est que comptee
+#endif
+
+// --- Evenements journalises sans pattern LED ni compteur, a la suite des ErrorCode ---
+enum : uint8_t {
+  JOURNAL_CLOCK_GPS = ERROR_COUNT,   // horloge corrigee depuis le GPS (contexte : ecart en s, borne a 255)
+  JOURNAL_CODE_COUNT
+};
+
+struct __attribute__((packed)) ErrorEvent {
+  uint32_t time;        // secondes depuis 2000-01-01
+  uint8_t code;         // ErrorCode ou JOURNAL_*
+  uint8_t context;      // precise l'erreur, propre a chaque code
+};
+
+// --- Fonctions publiques ---
+void ErrorJournal_Init();
+void ErrorJournal_Record(uint8_t code, uint8_t context = 0);     // O(1), sans allocation
+void ErrorJournal_Report(ErrorCode code, uint8_t context = 0);   // journal + pattern LED
+void ErrorJournal_Update();                                      // ecritures EEPROM differees
+void ErrorJournal_Dump();
+void ErrorJournal_Clear();
+
+#endif // ERROR_JOURNAL_H
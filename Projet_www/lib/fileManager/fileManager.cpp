@@ -1,95 +1,948 @@
 #include <SD.h>
 #include <clockManager.h>
 #include <ConfigManager.h>
+#include <RecordFormatter.h>
+#include <MemoryManager.h>
+#include <Crc16.h>
+#include <Backlog.h>
+#include <ErrorJournal.h>
+#include "fileManager.h"
 
 #define CHIPSELECT 4
 
-unsigned int maxFileSize = configParams.FILE_MAX_SIZE;
+// Contexte des erreurs ERROR_SD_ACCESS / ERROR_SD_FULL (journal des erreurs)
+#define SD_CTX_INIT 0
+#define SD_CTX_WRITE 1
+#define SD_CTX_OPEN 2
+
+#if LOG_MEMORY_WATERMARK
+#define LOG_EXTRA_SIZE sizeof(uint16_t)
+#define LOG_LINE_EXTRA_MAX 10          // ";ram:65535"
+#else
+#define LOG_EXTRA_SIZE 0
+#define LOG_LINE_EXTRA_MAX 0
+#endif
+
+// Trame binaire complete (voir LogFormat.h)
+#define LOG_RECORD_SIZE (sizeof(LogFrameHead) + sizeof(LogSummary) + LOG_EXTRA_SIZE + sizeof(uint16_t))
+#define LOG_FRAME_MAX 64
+static_assert(LOG_RECORD_SIZE <= LOG_FRAME_MAX, "trame plus grande que LOG_FRAME_MAX");
+
+// Fin de ligne texte la plus longue : ";seq:65535;crc:XXXX\n"
+#define LOG_LINE_FRAME_MAX 20
+
+#if LOG_FORMAT_BINARY
+#define LOG_EXT "BIN"
+#define LOG_DATA_START sizeof(LogFileHeader)   // premier enregistrement
+#else
+#define LOG_EXT "LOG"
+#define LOG_DATA_START 0
+#endif
+
+// --- Derive de la configuration, relu quand sa version change ---
+static uint32_t maxFileSize = 0;
+static uint8_t configVersion = 0;
+
+// --- Fichier courant (garde ouvert entre deux enregistrements) ---
+static File logFile;
+static char currentDate[7] = "";
+static uint16_t logDay = 0xFFFF;       // jour du fichier ouvert (Clock_Day)
+static uint16_t currentRev = 0;        // revision courante, trouvee une seule fois par jour
+static uint8_t clockSteps = 0;         // Clock_StepBacks() du fichier ouvert
+static uint32_t fileSize = 0;          // taille suivie en RAM, pas de f.size()
+
+// --- Tampon du secteur courant ---
+static_assert(LOG_SECTOR_SIZE % LOG_BUFFER_SIZE == 0, "LOG_BUFFER_SIZE doit diviser 512");
+static uint8_t sectorBuf[LOG_BUFFER_SIZE];
+static uint16_t bufFill = 0;           // position dans le secteur courant
+static uint16_t bufFlushed = 0;        // octets du secteur deja ecrits sur la carte
+static uint8_t pendingRecords = 0;
+static unsigned long pendingSince = 0;
+
+// --- Entrees d'index en attente (ecrites apres les donnees qu'elles designent) ---
+static LogIndexEntry indexPending[LOG_INDEX_PENDING];
+static uint8_t indexCount = 0;
+static uint32_t nextIndexAt = 0;       // offset a partir duquel indexer le prochain enregistrement
+
+// --- Politique de vidage ---
+static uint8_t flushRecords = LOG_FLUSH_RECORDS;
+static unsigned long flushDelayMs = LOG_FLUSH_DELAY_MS;
+
+// --- Trames ---
+static uint16_t logSeq = 0;            // sequence du prochain enregistrement, reprise au demarrage
+
+// --- Etat de la carte ---
+static bool sdReady = false;
+static bool writeError = false;        // ecriture incomplete depuis le dernier enregistrement
+static unsigned long lastRetry = 0;
+static bool draining = false;          // ecritures de la file d'attente, gardees jusqu'au vidage
+
+// --- Compteurs ---
+static uint32_t flushCount = 0;
+static uint32_t bytesWritten = 0;
+static uint32_t recoveredBytes = 0;    // fin de fichier non valide effacee au demarrage
+static uint32_t drainedRecords = 0;    // enregistrements de la file d'attente ecrits
+static uint32_t drainMs = 0;           // temps passe a les ecrire
+static uint32_t unflushedLost = 0;     // enregistrements tamponnes jamais vides (carte en defaut)
+static uint16_t purgedDays = 0;
+
+static void recoverLog();
 
 bool init_SD() {
   if (!SD.begin(CHIPSELECT)) {
     Serial.println(F("[ERROR] Check: card inserted, wiring, chipSelect pin."));
+    ErrorJournal_Report(ERROR_SD_ACCESS, SD_CTX_INIT);
+    lastRetry = millis();
     return false;
   }
+  sdReady = true;
+  recoverLog();
   Serial.println(F("[INFO] FileManager initialisé"));
   return true;
 }
 
-bool saveData(char data[256]) {
+// --- Ecrit la partie du secteur pas encore envoyee a la carte ---
+// En cas d'echec, les octets restent dans le tampon et writeError reste leve
+// jusqu'a ce que cardFailed() le traite.
+static bool writeSector(bool sync) {
+  if (logFile && bufFill > bufFlushed) {
+    size_t n = bufFill - bufFlushed;
+    if (logFile.write(sectorBuf + bufFlushed, n) != n) {
+      writeError = true;
+      return false;
+    }
+    bytesWritten += n;
+    flushCount++;
+  }
+  if (logFile && sync) logFile.flush();
+
+  bufFlushed = bufFill;
+  if (bufFill >= LOG_BUFFER_SIZE) bufFill = bufFlushed = 0;
+  return true;
+}
+
+static void appendBytes(const uint8_t *data, size_t len) {
+  // Tampon bloque par une ecriture en echec : l'enregistrement est abandonne
+  if (writeError) return;
+  while (len > 0) {
+    size_t n = LOG_BUFFER_SIZE - bufFill;
+    if (n > len) n = len;
+    memcpy(sectorBuf + bufFill, data, n);
+    bufFill += n;
+    fileSize += n;
+    data += n;
+    len -= n;
+
+    // Tranche complete : une seule ecriture alignee
+    if (bufFill >= LOG_BUFFER_SIZE && !writeSector(false)) return;
+  }
+}
+
+// --- Noms 8.3 : AAMMJJrr.EXT, revision rr en base 36 ---
+static char revDigit(uint8_t v) {
+  return v < 10 ? '0' + v : 'A' + v - 10;
+}
+
+static int8_t revValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+  return -1;
+}
+
+static void logName(char *name, const char *date, uint16_t rev, const char *ext) {
+  snprintf(name, 13, "%s%c%c.%s", date, revDigit(rev / 36), revDigit(rev % 36), ext);
+}
+
+// --- Ajoute les entrees en attente a l'index du fichier courant ---
+// En cas d'echec, les entrees restent en attente pour le prochain vidage.
+static bool writeIndex() {
+  if (!indexCount) return true;
+  char name[13];
+  logName(name, currentDate, currentRev, "IDX");
+  size_t len = indexCount * sizeof(LogIndexEntry);
+
+  File idx = SD.open(name, FILE_WRITE);
+  if (!idx) return false;
+  bool ok = idx.write((const uint8_t*)indexPending, len) == len;
+  idx.close();
+  if (ok) indexCount = 0;
+  return ok;
+}
+
+static bool openLog(const char *date, uint16_t rev) {
+  char name[13];
+  logName(name, date, rev, LOG_EXT);
+
+  logFile = SD.open(name, FILE_WRITE);
+  if (!logFile) return false;
+
+  fileSize = logFile.size();
+  bufFill = bufFlushed = fileSize % LOG_BUFFER_SIZE;
+  strcpy(currentDate, date);
+  currentRev = rev;
+
+#if LOG_FORMAT_BINARY
+  // Nouveau fichier : en-tete avant le premier enregistrement
+  if (fileSize == 0) {
+    LogFileHeader h;
+    h.magic[0] = LOG_MAGIC_0; h.magic[1] = LOG_MAGIC_1;
+    h.magic[2] = LOG_MAGIC_2; h.magic[3] = LOG_MAGIC_3;
+    h.version = LOG_SCHEMA_VERSION;
+    h.recordSize = LOG_RECORD_SIZE;
+    h.stationId = configParams.STATION_ID;
+    h.startTime = getTimestamp();
+    appendBytes((const uint8_t*)&h, sizeof(h));
+  }
+#endif
+  // Premier enregistrement apres l'ouverture toujours indexe
+  nextIndexAt = fileSize;
+  return true;
+}
+
+// --- Nom de journal attendu : AAMMJJrr.LOG (ou .BIN) ---
+static bool parseLogName(const char *n, uint16_t &rev) {
+  for (uint8_t i = 0; i < 6; i++) if (n[i] < '0' || n[i] > '9') return false;
+  int8_t hi = revValue(n[6]), lo = revValue(n[7]);
+  if (hi < 0 || lo < 0 || strcasecmp(n + 8, "." LOG_EXT)) return false;
+  rev = hi * 36 + lo;
+  return true;
+}
+
+// --- Derniere revision d'un jour, ou du dernier jour present si date est vide ---
+// (anterieur a before s'il est donne). Un seul parcours du repertoire ; date
+// recoit alors le jour trouve.
+static bool findLastLog(char *date, uint16_t &last, const char *before = NULL) {
+  bool anyDay = !date[0];
+  bool found = false;
+  File root = SD.open("/");
+  if (!root) return false;
+
+  File entry;
+  uint16_t rev;
+  while ((entry = root.openNextFile())) {
+    const char *n = entry.name();
+    if (!entry.isDirectory() && parseLogName(n, rev)) {
+      int c = strncmp(n, date, 6);   // AAMMJJ : ordre des noms = ordre des jours
+      bool older = !before || strncmp(n, before, 6) < 0;
+      if ((anyDay && c > 0 && older) || (c == 0 && (!found || rev > last))) {
+        if (c) { memcpy(date, n, 6); date[6] = '\0'; }
+        last = rev;
+        found = true;
+      }
+    }
+    entry.close();
+  }
+  root.close();
+  return found;
+}
+
+static uint16_t findLastRevision(const char *date) {
+  char d[7];
+  strcpy(d, date);
+  uint16_t last = 0;
+  findLastLog(d, last);
+  return last;
+}
+
+// --- Ouverture du fichier du jour, au demarrage ou au changement de date ---
+// Apres un recul de l'heure, la derniere revision peut finir plus tard : on ne la complete pas.
+static bool openDay(const char *date, bool stepped) {
+  uint16_t rev = findLastRevision(date);
+  if (!openLog(date, rev)) return false;
+  if ((fileSize < maxFileSize && !(stepped && fileSize > LOG_DATA_START)) || rev >= LOG_REV_MAX) return true;
+
+  FileManager_Close();
+  return openLog(date, rev + 1);
+}
+
+// --- Passe a la revision suivante sans recopier le fichier ---
+// Derniere revision du jour : le fichier depasse FILE_MAX_SIZE, le journal continue.
+static bool rotateLog() {
+  if (currentRev >= LOG_REV_MAX) return true;
   char date[7];
-  getAAMMJJ(date);
-  Serial.print("date : ");
-  Serial.println(date);
-  
-  // Nom du fichier : AAMMJJ_0.LOG
-  char name0[20];
-  snprintf(name0, sizeof(name0), "%s_0.LOG", date);
+  strcpy(date, currentDate);
+  uint16_t rev = currentRev + 1;
+
+  FileManager_Close();
+  return openLog(date, rev);
+}
+
+// --- Prepare le fichier du jour pour un enregistrement de len octets ---
+static bool prepareLog(size_t len) {
+  if (configVersion != ConfigManager_Version()) {
+    configVersion = ConfigManager_Version();
+    maxFileSize = configParams.FILE_MAX_SIZE;
+  }
+
+  // Heure reculee : nouvelle revision, l'index de chaque fichier reste trie
+  bool stepped = clockSteps != Clock_StepBacks();
+  clockSteps = Clock_StepBacks();
 
-  // Crée le fichier s'il n'existe pas
-  if (!SD.exists(name0)) {
-    File nf = SD.open(name0, FILE_WRITE);
-    if (!nf) return false;
-    nf.close();
+  // Changement de jour : on ferme le fichier de la veille
+  if (Clock_DateChanged(logDay) && logFile) FileManager_Close();
+  if (!logFile) {
+    char date[7];
+    getAAMMJJ(date);
+    if (!openDay(date, stepped)) return false;
   }
+  else if (stepped && !rotateLog()) return false;
 
   // Vérifie la taille et archive si nécessaire
-  {
-    File f = SD.open(name0, FILE_READ);
-    if (!f) return false;
-    size_t sz = f.size()+256;
-    f.close();
+  if (fileSize + len >= maxFileSize) {
+    if (!rotateLog()) return false;
+  }
+
+  if (pendingRecords == 0) pendingSince = millis();
+  return true;
+}
+
+// --- Entree d'index pour l'enregistrement qui commence a fileSize ---
+static void indexRecord(uint32_t time) {
+  if (fileSize < nextIndexAt) return;
+  if (indexCount >= LOG_INDEX_PENDING) FileManager_Flush();
+  // Carte en defaut : enregistrement non indexe, la recherche part d'une entree plus ancienne
+  if (indexCount >= LOG_INDEX_PENDING) return;
+  indexPending[indexCount].time = time;
+  indexPending[indexCount].offset = fileSize;
+  indexCount++;
+  nextIndexAt = fileSize + LOG_INDEX_SPACING;
+}
+
+// Compte apres le vidage : si celui-ci echoue, l'enregistrement courant repart
+// en file d'attente et seuls les precedents sont comptes perdus
+static bool recordDone() {
+  if (flushRecords && pendingRecords + 1 >= flushRecords) return FileManager_Flush();
+  pendingRecords++;
+  return true;
+}
+
+// --- Ecriture formatee directement dans le tampon du secteur, CRC au passage ---
+class SectorPrint : public Print {
+public:
+  uint16_t crc = CRC16_INIT;
+  size_t write(uint8_t c) override {
+    crc = Crc16_Update(crc, c);
+    appendBytes(&c, 1);
+    return 1;
+  }
+  size_t write(const uint8_t *data, size_t len) override {
+    crc = Crc16_Compute(data, len, crc);
+    appendBytes(data, len);
+    return len;
+  }
+};
+
+// --- Fin de trame d'une ligne texte : ;seq:<n>;crc:<XXXX>\n ---
+static void endLine(SectorPrint &out) {
+  out.print(F(";seq:"));
+  out.print(logSeq++);
+  out.print(F(";crc:"));
+  uint16_t crc = out.crc;
+  for (int8_t shift = 12; shift >= 0; shift -= 4) out.write("0123456789ABCDEF"[(crc >> shift) & 0xF]);
+  out.write('\n');
+}
+
+bool saveData(const char *data) {
+  size_t len = strnlen(data, LOG_SECTOR_SIZE);
+  // Le saut de ligne final est celui de la trame
+  while (len > 0 && (data[len - 1] == '\n' || data[len - 1] == '\r')) len--;
+
+  if (!prepareLog(len + LOG_LINE_FRAME_MAX)) return false;
 
-    if (sz >= maxFileSize) {
-      // Cherche la prochaine révision libre
-      int rev = 1;
-      char nameX[20];
-      for (; rev < 1000; ++rev) {
-        snprintf(nameX, sizeof(nameX), "%s_%d.LOG", date, rev);
-        if (!SD.exists(nameX)) break;
+  SectorPrint out;
+  out.write((const uint8_t*)data, len);
+  endLine(out);
+  return recordDone();
+}
+
+// --- Ecriture d'un enregistrement sur la carte ---
+static bool writeSummary(const LogSummary &summary) {
+#if LOG_FORMAT_BINARY
+  if (!prepareLog(LOG_RECORD_SIZE)) return false;
+  indexRecord(summary.time);
+
+  LogFrameHead head = { LOG_SYNC, logSeq++ };
+  uint16_t crc = Crc16_Compute(&head, sizeof(head));
+  crc = Crc16_Compute(&summary, sizeof(summary), crc);
+  appendBytes((const uint8_t*)&head, sizeof(head));
+  appendBytes((const uint8_t*)&summary, sizeof(LogSummary));
+#if LOG_MEMORY_WATERMARK
+  uint16_t freeRam = MemoryManager_StackHighWater();
+  crc = Crc16_Compute(&freeRam, sizeof(freeRam), crc);
+  appendBytes((const uint8_t*)&freeRam, sizeof(freeRam));
+#endif
+  appendBytes((const uint8_t*)&crc, sizeof(crc));
+#else
+  // Pas de copie de la ligne en RAM : la rotation est decidee sur la longueur
+  // maximale d'une ligne de ce type (echantillon seul ou fenetre)
+  uint16_t lineMax = summary.count > 1 ? RECORD_SUMMARY_MAX : RECORD_SAMPLE_MAX;
+  if (!prepareLog(lineMax + LOG_LINE_EXTRA_MAX + LOG_LINE_FRAME_MAX)) return false;
+  indexRecord(summary.time);
+  SectorPrint out;
+  RecordFormatter_WriteSummary(out, summary);
+#if LOG_MEMORY_WATERMARK
+  out.print(F(";ram:"));
+  out.print(MemoryManager_StackHighWater());
+#endif
+  endLine(out);
+#endif
+  if (writeError) return false;
+  // Un index incomplet ne perd aucune donnee : seules les ecritures du journal comptent
+  recordDone();
+  return !writeError;
+}
+
+// Jour AAMMJJ du plus ancien journal, en un seul parcours de la racine
+static bool findOldestDay(char *oldest) {
+  oldest[0] = '\0';
+  File root = SD.open("/");
+  if (!root) return false;
+  File entry;
+  uint16_t rev;
+  while ((entry = root.openNextFile())) {
+    const char *n = entry.name();
+    if (!entry.isDirectory() && parseLogName(n, rev) && (!oldest[0] || strncmp(n, oldest, 6) < 0)) {
+      memcpy(oldest, n, 6);
+      oldest[6] = '\0';
+    }
+    entry.close();
+  }
+  root.close();
+  return oldest[0] != '\0';
+}
+
+#if LOG_PURGE_OLDEST
+// --- Carte pleine : supprime les journaux du jour le plus ancien, jamais celui du jour ---
+static bool purgeOldestDay() {
+  char oldest[7], today[7];
+  findOldestDay(oldest);
+
+  getAAMMJJ(today);
+  if (!oldest[0] || strcmp(oldest, today) >= 0) return false;
+
+  uint16_t last = findLastRevision(oldest);
+  for (uint16_t r = 0; r <= last; r++) {
+    char name[13];
+    logName(name, oldest, r, LOG_EXT);
+    SD.remove(name);
+    logName(name, oldest, r, "IDX");
+    SD.remove(name);
+  }
+  purgedDays++;
+  Serial.print(F("[INFO] Carte pleine, journaux du "));
+  Serial.print(oldest);
+  Serial.println(F(" supprimes"));
+  return true;
+}
+#endif
+
+// --- Echec d'ecriture : carte consideree absente jusqu'a la prochaine tentative ---
+static void cardFailed(bool opened) {
+  // Ecriture incomplete dans un fichier ouvert : carte pleine si elle repond encore
+  bool full = false;
+  if (logFile) {
+    char name[13];
+    logName(name, currentDate, currentRev, LOG_EXT);
+    logFile.close();
+    currentDate[0] = '\0';
+    if (opened && writeError) {
+      File f = SD.open(name, FILE_READ);
+      full = f;
+      if (f) f.close();
+    }
+  }
+  ErrorJournal_Report(full ? ERROR_SD_FULL : ERROR_SD_ACCESS, full ? SD_CTX_WRITE : SD_CTX_OPEN);
+  writeError = false;
+  // Enregistrements du tampon jamais vides : le fichier est ferme sans eux.
+  // Ceux de la file d'attente y restent et seront reecrits.
+  if (!draining) unflushedLost += pendingRecords;
+  pendingRecords = 0;
+  indexCount = 0;
+#if LOG_PURGE_OLDEST
+  if (full && purgeOldestDay()) return;
+#endif
+  sdReady = false;
+  lastRetry = millis();
+}
+
+static bool trySave(const LogSummary &summary) {
+  if (writeSummary(summary)) return true;
+  cardFailed(logFile);
+  return false;
+}
+
+// --- Vidage hors enregistrement : un echec d'ecriture rend la carte indisponible ---
+static bool flushLog() {
+  FileManager_Flush();
+  if (!writeError) return true;
+  cardFailed(true);
+  return false;
+}
+
+// --- Nouvelle tentative d'initialisation, au plus toutes les BACKLOG_RETRY_MS ---
+static bool retryCard() {
+  if (millis() - lastRetry < BACKLOG_RETRY_MS) return false;
+  lastRetry = millis();
+  SD.end();
+  if (!SD.begin(CHIPSELECT)) return false;
+  sdReady = true;
+  recoverLog();
+  Serial.println(F("[INFO] Carte SD de nouveau disponible"));
+  return true;
+}
+
+// --- Vidage de la file d'attente par lots de BACKLOG_BATCH ---
+// Les enregistrements ne quittent la file qu'une fois le lot vide sur la carte :
+// un echec peut en dupliquer, pas en perdre.
+static void drainBacklog() {
+  if (!Backlog_Count()) return;
+  if (!sdReady && !retryCard()) return;
+  // Enregistrements directs encore en tampon : vides avant le lot
+  if (pendingRecords && !flushLog()) return;
+
+  unsigned long start = millis();
+  uint8_t n = 0;
+  LogSummary summary;
+  bool ok = true;
+  draining = true;
+  while (ok && n < BACKLOG_BATCH && Backlog_Peek(summary, n)) {
+    ok = trySave(summary);
+    n++;
+  }
+  ok = ok && flushLog();
+  draining = false;
+  if (!ok) return;
+  for (uint8_t i = 0; i < n; i++) Backlog_Pop();
+  drainedRecords += n;
+  drainMs += millis() - start;
+}
+
+bool saveSummary(const LogSummary &summary) {
+  // L'ordre chronologique est conserve : rien n'est ecrit avant la file d'attente
+  if (sdReady && !Backlog_Count() && trySave(summary)) return true;
+  Backlog_Push(summary);
+  return false;
+}
+
+// --- Vidage sur delai, appele depuis la boucle principale ---
+void FileManager_Update() {
+  drainBacklog();
+  if (pendingRecords && flushDelayMs && millis() - pendingSince >= flushDelayMs) {
+    flushLog();
+  }
+}
+
+// L'index n'est ecrit qu'apres les donnees qu'il designe
+bool FileManager_Flush() {
+  if (!writeSector(true)) return false;
+  pendingRecords = 0;
+  return writeIndex();
+}
+
+void FileManager_Close() {
+  if (!logFile) return;
+  FileManager_Flush();
+  logFile.close();
+  currentDate[0] = '\0';
+  indexCount = 0;   // entrees non ecrites : propres a ce fichier
+}
+
+void FileManager_SetFlushPolicy(uint8_t maxRecords, unsigned long maxDelayMs) {
+  flushRecords = maxRecords;
+  flushDelayMs = maxDelayMs;
+}
+
+void FileManager_PrintStats() {
+  Serial.println(F("=== Journal SD ==="));
+  Serial.print(F("Fichier: "));
+  if (logFile) {
+    char name[13];
+    logName(name, currentDate, currentRev, LOG_EXT);
+    Serial.println(name);
+  } else Serial.println('-');
+  Serial.print(F("Taille: ")); Serial.println(fileSize);
+  Serial.print(F("Tampon: ")); Serial.print(bufFill - bufFlushed); Serial.print(F(" octets, "));
+  Serial.print(pendingRecords); Serial.println(F(" enregistrements"));
+  Serial.print(F("Vidages: ")); Serial.println(flushCount);
+  Serial.print(F("Octets ecrits: ")); Serial.println(bytesWritten);
+  Serial.print(F("Sequence: ")); Serial.println(logSeq);
+  Serial.print(F("Repare au demarrage: ")); Serial.print(recoveredBytes); Serial.println(F(" octets"));
+  Serial.print(F("Carte: ")); Serial.println(sdReady ? F("prete") : F("indisponible"));
+  Serial.print(F("Attente: ")); Serial.print(Backlog_Count()); Serial.print(F(" ("));
+  Serial.print(Backlog_Slots()); Serial.print('/'); Serial.print(BACKLOG_DEPTH);
+  Serial.print(F(" places, max ")); Serial.print(Backlog_MaxCount()); Serial.print(F("), perdus: ")); Serial.println(Backlog_Dropped());
+  Serial.print(F("Non vides (carte en defaut): ")); Serial.println(unflushedLost);
+  Serial.print(F("Rattrapage: ")); Serial.print(drainedRecords); Serial.print(F(" enregistrements"));
+  if (drainMs) { Serial.print(F(", ")); Serial.print(drainedRecords * 1000UL / drainMs); Serial.print(F(" /s")); }
+  Serial.println();
+  Serial.print(F("Jours purges: ")); Serial.println(purgedDays);
+  Serial.println(F("=================="));
+}
+
+// --- Lecture des trames ---
+#if LOG_FORMAT_BINARY
+// En-tete d'un journal de la version courante
+static bool readHeader(File &f, uint8_t &recordSize) {
+  LogFileHeader h;
+  f.seek(0);
+  if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h) || h.version != LOG_SCHEMA_VERSION) return false;
+  recordSize = h.recordSize;
+  return recordSize >= sizeof(LogFrameHead) + sizeof(LogSummary) + sizeof(uint16_t) &&
+         recordSize <= LOG_FRAME_MAX;
+}
+
+// Prochaine trame intacte a partir de pos ; pos pointe ensuite apres elle.
+// Une trame invalide (fin coupee, zone effacee) est sautee jusqu'au LOG_SYNC suivant.
+static bool nextFrame(File &f, uint32_t &pos, uint8_t size, uint8_t *frame) {
+  for (;;) {
+    f.seek(pos);
+    if (f.read(frame, size) != size) return false;
+
+    uint16_t crc;
+    memcpy(&crc, frame + size - sizeof(crc), sizeof(crc));
+    if (frame[0] == LOG_SYNC && Crc16_Compute(frame, size - sizeof(crc)) == crc) {
+      pos += size;
+      return true;
+    }
+    const uint8_t *next = (const uint8_t*)memchr(frame + 1, LOG_SYNC, size - 1);
+    pos += next ? next - frame : size;
+  }
+}
+
+// Fin de la derniere trame intacte apres pos, et sa sequence
+static bool scanFrames(File &f, uint32_t pos, uint32_t &validEnd, uint16_t &lastSeq) {
+  uint8_t recordSize;
+  if (!readHeader(f, recordSize)) return false;
+  if (pos < sizeof(LogFileHeader)) pos = sizeof(LogFileHeader);
+
+  bool found = false;
+  uint8_t frame[LOG_FRAME_MAX];
+  while (nextFrame(f, pos, recordSize, frame)) {
+    LogFrameHead head;
+    memcpy(&head, frame, sizeof(head));
+    lastSeq = head.seq;
+    validEnd = pos;
+    found = true;
+  }
+  return found;
+}
+
+// Sans trame intacte, tout ce qui suit l'en-tete est efface ; un fichier d'une
+// autre version ou a l'en-tete coupe n'est pas touche
+static uint32_t tailStart(File &f) {
+  uint8_t recordSize;
+  return readHeader(f, recordSize) ? sizeof(LogFileHeader) : f.size();
+}
+
+#define LOG_FILL_BYTE 0
+#else
+// Motif de fin de ligne reconnu caractere par caractere (pas de ';' apres le premier)
+static uint8_t matchTag(uint8_t m, char c, const char *tag) {
+  if (c == tag[m]) return m + 1;
+  return c == ';' ? 1 : 0;
+}
+
+// Fin de la derniere ligne intacte apres pos (CRC verifie), et sa sequence
+static bool scanFrames(File &f, uint32_t pos, uint32_t &validEnd, uint16_t &lastSeq) {
+  enum { BODY, CRC_DIGITS, END, BAD } state = BODY;
+  uint16_t crc = CRC16_INIT, lineCrc = 0, hex = 0, seq = 0;
+  uint8_t mCrc = 0, mSeq = 0, digits = 0;
+  bool inSeq = false, found = false;
+  uint8_t buf[32];
+  int len;
+
+  f.seek(pos);
+  while ((len = f.read(buf, sizeof(buf))) > 0) {
+    for (int i = 0; i < len; i++, pos++) {
+      char c = buf[i];
+      if (c == '\n') {
+        if (state == END && hex == lineCrc) {
+          validEnd = pos + 1;
+          lastSeq = seq;
+          found = true;
+        }
+        state = BODY; crc = CRC16_INIT; mCrc = mSeq = 0; inSeq = false;
+        continue;
       }
-      if (rev == 1000) return false; // sécurité
-
-      // Copie _0.LOG -> _n.LOG
-      File src = SD.open(name0, FILE_READ);
-      if (!src) return false;
-      File dst = SD.open(nameX, FILE_WRITE);
-      if (!dst) { src.close(); return false; }
-
-      uint8_t buf[64];
-      while (src.available()) {
-        int n = src.read(buf, sizeof(buf));
-        if (n <= 0) break;
-        if (dst.write(buf, n) != n) { src.close(); dst.close(); return false; }
+
+      if (state == BODY) {
+        crc = Crc16_Update(crc, c);
+        if (inSeq) {
+          if (c >= '0' && c <= '9') seq = seq * 10 + (c - '0');
+          else inSeq = false;
+        }
+        if ((mSeq = matchTag(mSeq, c, ";seq:")) == 5) { inSeq = true; seq = 0; mSeq = 0; }
+        if ((mCrc = matchTag(mCrc, c, ";crc:")) == 5) { state = CRC_DIGITS; lineCrc = crc; hex = 0; digits = 0; }
       }
-      src.close();
-      dst.close();
-
-      // Réinitialise _0.LOG
-      SD.remove(name0);
-      File nf = SD.open(name0, FILE_WRITE);
-      if (!nf) return false;
-      nf.close();
+      else if (state == CRC_DIGITS) {
+        uint8_t v = (c >= '0' && c <= '9') ? c - '0' : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0xFF;
+        if (v == 0xFF) state = BAD;
+        else {
+          hex = (hex << 4) | v;
+          if (++digits == 4) state = END;
+        }
+      }
+      else state = BAD;
     }
   }
+  return found;
+}
+
+// Sans ligne intacte, seule la ligne incomplete de la fin est effacee : les
+// lignes ecrites avant la v3 (sans seq ni crc) sont conservees
+static uint32_t tailStart(File &f) {
+  uint32_t pos = f.size();
+  uint8_t buf[32];
+  while (pos > 0) {
+    uint8_t n = pos < sizeof(buf) ? pos : sizeof(buf);
+    pos -= n;
+    f.seek(pos);
+    if (f.read(buf, n) != n) break;
+    for (uint8_t i = n; i-- > 0; ) if (buf[i] == '\n') return pos + i + 1;
+  }
+  return 0;
+}
 
-  // Écrit la ligne dans le fichier courant
-  size_t len = 0;
-  while (len < 256 && data[len] != '\0') ++len;
+#define LOG_FILL_BYTE '\n'
+#endif
 
-  File f = SD.open(name0, FILE_WRITE);
-  if (!f) return false;
+// --- Reprise apres coupure ---
+// Les donnees designees par la derniere entree d'index ont ete ecrites avant
+// elle : seule la suite du dernier journal est relue. Tout ce qui suit la
+// derniere trame intacte est efface (la bibliotheque SD ne sait pas tronquer
+// un fichier) et la sequence reprend apres cette trame. Sans trame intacte
+// (fichier neuf, en-tete seul, index faux), la sequence reprend apres la
+// derniere trame des journaux precedents.
+#define LOG_SEQ_LOOKBACK 4   // journaux precedents relus au plus
+static uint32_t lastIndexOffset(const char *date, uint16_t rev) {
+  char name[13];
+  logName(name, date, rev, "IDX");
+  File idx = SD.open(name, FILE_READ);
+  if (!idx) return 0;
 
-  bool ok = true;
-  if (f.write((const uint8_t*)data, len) != (int)len) ok = false;
+  LogIndexEntry e;
+  uint32_t size = idx.size();
+  e.offset = 0;
+  if (size >= sizeof(e)) {
+    idx.seek(size - size % sizeof(e) - sizeof(e));
+    if (idx.read((uint8_t*)&e, sizeof(e)) != sizeof(e)) e.offset = 0;
+  }
+  idx.close();
+  return e.offset;
+}
 
-  // Ajoute un saut de ligne si absent
-  if (ok) {
-    char last = (len > 0) ? data[len - 1] : '\0';
-    if (last != '\n' && last != '\r') {
-      if (f.write('\n') != 1) ok = false;
+// Fin du fichier sans la zone deja effacee par une reprise precedente
+static uint32_t unfilledEnd(File &f, uint32_t from, uint32_t size) {
+  uint8_t buf[32];
+  while (size > from) {
+    uint8_t n = size - from < sizeof(buf) ? size - from : sizeof(buf);
+    f.seek(size - n);
+    if (f.read(buf, n) != n) break;
+    for (uint8_t i = n; i-- > 0; size--) if (buf[i] != LOG_FILL_BYTE) return size;
+  }
+  return size;
+}
+
+// Derniere trame intacte : apres la derniere entree d'index, sinon dans tout le fichier
+static bool lastFrame(File &f, const char *date, uint16_t rev, uint32_t &validEnd, uint16_t &seq) {
+  uint32_t from = lastIndexOffset(date, rev);
+  if (scanFrames(f, from, validEnd, seq)) return true;
+  return from > 0 && scanFrames(f, 0, validEnd, seq);
+}
+
+// Sequence de la derniere trame des journaux precedents (revisions du jour, puis jours d'avant)
+static bool previousSeq(const char *date, uint16_t rev, uint16_t &seq) {
+  char day[7];
+  strcpy(day, date);
+  for (uint8_t n = 0; n < LOG_SEQ_LOOKBACK; n++) {
+    if (rev > 0) rev--;
+    else {
+      char before[7];
+      strcpy(before, day);
+      day[0] = '\0';
+      if (!findLastLog(day, rev, before)) return false;
     }
+
+    char name[13];
+    logName(name, day, rev, LOG_EXT);
+    File f = SD.open(name, FILE_READ);
+    if (!f) continue;
+    uint32_t end;
+    bool found = lastFrame(f, day, rev, end, seq);
+    f.close();
+    if (found) return true;
   }
+  return false;
+}
+
+static void recoverLog() {
+  char date[7] = "";
+  uint16_t rev;
+  if (!findLastLog(date, rev)) return;
 
+  char name[13];
+  logName(name, date, rev, LOG_EXT);
+  File f = SD.open(name, O_READ | O_WRITE);
+  if (!f) return;
+
+  uint32_t size = f.size(), validEnd = 0;
+  uint16_t seq;
+  bool found = lastFrame(f, date, rev, validEnd, seq);
+  if (!found) {
+    validEnd = tailStart(f);
+    found = previousSeq(date, rev, seq);
+  }
+  if (found) logSeq = seq + 1;
+  size = unfilledEnd(f, validEnd, size);
+  if (validEnd < size) {
+    uint8_t fill[32];
+    memset(fill, LOG_FILL_BYTE, sizeof(fill));
+    f.seek(validEnd);
+    for (uint32_t left = size - validEnd; left; ) {
+      uint8_t n = left < sizeof(fill) ? left : sizeof(fill);
+      f.write(fill, n);
+      left -= n;
+    }
+    f.flush();
+    recoveredBytes = size - validEnd;
+    Serial.print(F("[INFO] Journal "));
+    Serial.print(name);
+    Serial.print(F(" repare : "));
+    Serial.print(recoveredBytes);
+    Serial.println(F(" octets effaces"));
+  }
   f.close();
-  return ok;
-}
\ No newline at end of file
+}
+
+// --- Extraction d'une plage horaire ---
+// L'index donne l'offset du dernier enregistrement indexe anterieur a from :
+// seuls au plus LOG_INDEX_SPACING octets sont lus avant la plage.
+
+// Offset de depart dans le journal name, false si le fichier commence apres to
+static bool indexLookup(const char *date, uint16_t rev, uint32_t from, uint32_t to, uint32_t &start) {
+  char name[13];
+  logName(name, date, rev, "IDX");
+  start = 0;
+  File idx = SD.open(name, FILE_READ);
+  if (!idx) return true;   // pas d'index : lecture depuis le debut
+
+  uint32_t count = idx.size() / sizeof(LogIndexEntry);
+  LogIndexEntry e;
+  bool inRange = true;
+  if (count && idx.read((uint8_t*)&e, sizeof(e)) == sizeof(e) && e.time > to) inRange = false;
+
+  // Recherche dichotomique de la derniere entree avec time <= from
+  uint32_t lo = 0, hi = count;
+  while (inRange && lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    idx.seek(mid * sizeof(LogIndexEntry));
+    if (idx.read((uint8_t*)&e, sizeof(e)) != sizeof(e)) break;
+    if (e.time <= from) { start = e.offset; lo = mid + 1; }
+    else hi = mid;
+  }
+  idx.close();
+  return inRange;
+}
+
+#if LOG_FORMAT_BINARY
+static uint32_t dumpFile(File &f, uint32_t start, uint32_t from, uint32_t to, Print &out, bool &done) {
+  uint8_t recordSize;
+  if (!readHeader(f, recordSize)) return 0;
+  uint32_t pos = start > sizeof(LogFileHeader) ? start : sizeof(LogFileHeader);
+
+  uint32_t n = 0;
+  uint8_t frame[LOG_FRAME_MAX];
+  LogSummary s;
+  while (nextFrame(f, pos, recordSize, frame)) {
+    // Octets en plus (LOG_MEMORY_WATERMARK) ignores
+    memcpy(&s, frame + sizeof(LogFrameHead), sizeof(s));
+    if (s.time > to) { done = true; break; }
+    if (s.time < from) continue;
+    RecordFormatter_WriteSummary(out, s);
+    out.write('\n');
+    n++;
+  }
+  return n;
+}
+#else
+// Lignes "time:<t>;..." recopiees telles quelles, par blocs
+static uint32_t dumpFile(File &f, uint32_t start, uint32_t from, uint32_t to, Print &out, bool &done) {
+  enum { HEAD, COPY, SKIP } state = HEAD;
+  char head[20];
+  uint8_t headLen = 0;
+  uint8_t buf[32];
+  uint32_t n = 0;
+  int len;
+
+  f.seek(start);
+  while (!done && (len = f.read(buf, sizeof(buf))) > 0) {
+    for (int i = 0; i < len; ) {
+      if (state == HEAD) {
+        char c = buf[i++];
+        if (headLen < sizeof(head) - 1) head[headLen++] = c;
+        if (c != ';' && c != '\n' && headLen < sizeof(head) - 1) continue;
+
+        head[headLen] = '\0';
+        bool timed = headLen > 5 && !strncmp(head, "time:", 5);
+        uint32_t t = timed ? strtoul(head + 5, NULL, 10) : 0;
+        if (timed && t > to) { done = true; break; }
+        bool keep = timed && t >= from;
+        if (keep) { out.write((const uint8_t*)head, headLen); n++; }
+        headLen = 0;
+        if (c != '\n') state = keep ? COPY : SKIP;
+      }
+      else {
+        const uint8_t *nl = (const uint8_t*)memchr(buf + i, '\n', len - i);
+        int end = nl ? nl - buf + 1 : len;
+        if (state == COPY) out.write(buf + i, end - i);
+        if (nl) state = HEAD;
+        i = end;
+      }
+    }
+  }
+  return n;
+}
+#endif
+
+uint32_t FileManager_Dump(uint32_t from, uint32_t to, Print &out) {
+  // Donnees en attente dans le tampon lisibles par l'extraction
+  flushLog();
+
+  // Aucun jour au-dela du jour courant ni de 2099 (AAMMJJ revient a 00 en 2100).
+  // Apres un recul de l'heure, le jour courant peut contenir des heures a venir.
+  uint32_t end = getTimestamp();
+  if (end > to) end = to;
+  uint32_t last = Clock_ToEpoch(2099, 12, 31, 23, 59, 59);
+  if (end > last) end = last;
+
+  // Les jours anterieurs au plus ancien journal ne sont pas parcourus
+  char oldest[7];
+  if (from / 86400UL > end / 86400UL || !findOldestDay(oldest)) return 0;
+  uint16_t first = Clock_ToEpoch(2000 + (oldest[0] - '0') * 10 + (oldest[1] - '0'),
+                                 (oldest[2] - '0') * 10 + (oldest[3] - '0'),
+                                 (oldest[4] - '0') * 10 + (oldest[5] - '0'), 0, 0, 0) / 86400UL;
+  if (from / 86400UL > first) first = from / 86400UL;
+
+  uint32_t n = 0;
+  for (uint16_t day = first; day <= end / 86400UL; day++) {
+    char date[7];
+    Clock_DayToAAMMJJ(day, date);
+    // Revisions contigues depuis 0, chacune triee : apres un recul de l'heure,
+    // une revision peut commencer avant la fin de la precedente
+    for (uint16_t rev = 0; rev <= LOG_REV_MAX; rev++) {
+      char name[13];
+      logName(name, date, rev, LOG_EXT);
+      if (!SD.exists(name)) break;
+
+      uint32_t start;
+      if (!indexLookup(date, rev, from, to, start)) continue;
+      File f = SD.open(name, FILE_READ);
+      if (!f) break;
+      bool done = false;
+      n += dumpFile(f, start, from, to, out, done);
+      f.close();
+    }
+  }
+  return n;
+}
@@ -1,8 +1,69 @@
 #ifndef SDMANAGER_H
 #define SDMANAGER_H
 
+#include <Arduino.h>
+#include <LogFormat.h>
+
+// --- Format des journaux ---
+// 0 : lignes texte (AAMMJJrr.LOG), 1 : enregistrements binaires (AAMMJJrr.BIN,
+// voir LogFormat.h, decodables avec tools/logdecode)
+#ifndef LOG_FORMAT_BINARY
+#define LOG_FORMAT_BINARY 0
+#endif
+
+// --- Revisions du jour ---
+// rr : revision en base 36 (00..ZZ), pour rester en 8.3. La derniere revision
+// grossit au-dela de FILE_MAX_SIZE plutot que d'arreter le journal.
+#define LOG_REV_MAX (36 * 36 - 1)
+
+// --- Tampon d'ecriture ---
+// Le tampon represente une tranche alignee du secteur courant du fichier : les
+// ecritures sur la carte ne chevauchent jamais deux secteurs de 512 octets.
+// 512 = un secteur entier par ecriture ; les petites tailles (64, 128, 256)
+// laissent de la RAM aux capteurs sur Uno.
+#define LOG_SECTOR_SIZE 512
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE LOG_SECTOR_SIZE
+#endif
+
+// --- Politique de vidage par defaut ---
+#ifndef LOG_FLUSH_RECORDS
+#define LOG_FLUSH_RECORDS 8          // vidage apres N enregistrements (0 = desactive)
+#endif
+#ifndef LOG_FLUSH_DELAY_MS
+#define LOG_FLUSH_DELAY_MS 60000UL   // vidage si des donnees attendent depuis ce delai (0 = desactive)
+#endif
+
+// --- Index des journaux (AAMMJJrr.IDX) ---
+#ifndef LOG_INDEX_SPACING
+#define LOG_INDEX_SPACING 1024       // octets de journal entre deux entrees d'index
+#endif
+#define LOG_INDEX_PENDING 4          // entrees gardees en RAM jusqu'au prochain vidage
+
+// --- Carte absente ou pleine ---
+// Les enregistrements attendent dans Backlog (RAM) et sont ecrits par lots
+// depuis FileManager_Update() quand la carte repond de nouveau.
+#ifndef BACKLOG_RETRY_MS
+#define BACKLOG_RETRY_MS 10000UL     // delai entre deux tentatives de SD.begin()
+#endif
+#ifndef BACKLOG_BATCH
+#define BACKLOG_BATCH 4              // enregistrements ecrits par passage
+#endif
+#ifndef LOG_PURGE_OLDEST
+#define LOG_PURGE_OLDEST 0           // 1 : carte pleine, supprime le jour le plus ancien
+#endif
+
 bool init_SD();
 
-bool saveData(char data[256]);
+bool saveData(const char *data);
+bool saveSummary(const LogSummary &summary);   // false : mis en attente (carte indisponible)
+
+// --- Fonctions publiques ---
+void FileManager_Update();
+bool FileManager_Flush();
+void FileManager_Close();
+void FileManager_SetFlushPolicy(uint8_t maxRecords, unsigned long maxDelayMs);
+void FileManager_PrintStats();
+uint32_t FileManager_Dump(uint32_t from, uint32_t to, Print &out);   // enregistrements de [from, to]
 
-#endif // SDMANAGER_H
\ No newline at end of file
+#endif // SDMANAGER_H
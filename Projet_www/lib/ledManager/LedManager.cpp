@@ -5,17 +5,21 @@
 
 // === Constantes ===
 static const LedPattern error_patterns[ERROR_COUNT] PROGMEM = {
-    {255, 0, 0,   0, 0, 255,     1, 1.0},   // RTC
-    {255, 0, 0,   255, 255, 0,   1.0, 1.0}, // GPS
-    {255, 0, 0,   0, 255, 0,     1.0, 1.0}, // Capteur acces
-    {255, 0, 0,   0, 255, 0,     1.0, 2.0}, // Capteur incoherent
-    {255, 0, 0,   255, 255, 255, 1.0, 1.0}, // SD pleine
-    {255, 0, 0,   255, 255, 255, 1.0, 2.0}  // SD acces
+    LED_PATTERN(255, 0, 0,   0, 0, 255,     1.0, 1.0), // RTC
+    LED_PATTERN(255, 0, 0,   255, 255, 0,   1.0, 1.0), // GPS
+    LED_PATTERN(255, 0, 0,   0, 255, 0,     1.0, 1.0), // Capteur acces
+    LED_PATTERN(255, 0, 0,   0, 255, 0,     1.0, 2.0), // Capteur incoherent
+    LED_PATTERN(255, 0, 0,   255, 255, 255, 1.0, 1.0), // SD pleine
+    LED_PATTERN(255, 0, 0,   255, 255, 255, 1.0, 2.0)  // SD acces
 };
 
+static_assert(ERROR_COUNT <= 8, "pending_errors est un masque de 8 bits");
+
 // === Variables globales ===
 static ChainableLED* led = nullptr;
 static ErrorCode current_error = (ErrorCode)-1;
+static LedPattern current_pattern;          // copie en RAM, lue une fois par pattern
+static uint8_t pending_errors = 0;          // bit n : ErrorCode n en attente
 static bool showing_first_color = true;
 static unsigned long last_update_time = 0;
 static uint8_t cycles_done = 0;
@@ -29,7 +33,21 @@ void LedManager_SetColor(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 bool LedManager_IsBusy() {
-    return current_error != (ErrorCode)-1;
+    return current_error != (ErrorCode)-1 || pending_errors;
+}
+
+static void startPattern(ErrorCode error_id) {
+    current_error = error_id;
+    showing_first_color = true;
+    last_update_time = millis();
+    cycles_done = 0;
+
+    memcpy_P(&current_pattern, &error_patterns[error_id], sizeof(LedPattern));
+    LedManager_SetColor(current_pattern.r1, current_pattern.g1, current_pattern.b1);
+
+    Serial.print(F("[ERROR] Pattern "));
+    Serial.print(error_id);
+    Serial.println(F(" active"));
 }
 
 // === Initialisation ===
@@ -53,61 +71,53 @@ void LedManager_RestoreModeColor() {
 }
 
 // === Feedback d’erreur ===
+// Une erreur signalee pendant un pattern est mise en attente (une fois par code)
 void LedManager_Feedback(ErrorCode error_id) {
     if (error_id >= ERROR_COUNT) return;
 
-    if (LedManager_IsBusy()) {
-        Serial.print(F("[INFO] Pattern dejà en cours ("));
-        Serial.print(current_error);
-        Serial.println(F("), ignore"));
+    if (current_error != (ErrorCode)-1) {
+        pending_errors |= (uint8_t)(1 << error_id);
         return;
     }
-
-    current_error = error_id;
-    showing_first_color = true;
-    last_update_time = millis();
-    cycles_done = 0;
-
-    LedPattern pattern;
-    memcpy_P(&pattern, &error_patterns[error_id], sizeof(LedPattern));
-    LedManager_SetColor(pattern.r1, pattern.g1, pattern.b1);
-
-    Serial.print(F("[ERROR] Pattern "));
-    Serial.print(error_id);
-    Serial.println(F(" active"));
+    startPattern(error_id);
 }
 
 // === Effacement du pattern ===
 void LedManager_Clear() {
     current_error = (ErrorCode)-1;
+    pending_errors = 0;
     cycles_done = 0;
     LedManager_RestoreModeColor();
 }
 
+// Fin d'un pattern : erreur en attente la plus prioritaire, sinon couleur du mode
+static void nextPattern() {
+    current_error = (ErrorCode)-1;
+    for (uint8_t e = 0; e < ERROR_COUNT; e++) {
+        if (pending_errors & (1 << e)) {
+            pending_errors &= (uint8_t)~(1 << e);
+            startPattern((ErrorCode)e);
+            return;
+        }
+    }
+    LedManager_RestoreModeColor();
+}
+
 // === Mise à jour ===
 void LedManager_Update() {
-    if (!LedManager_IsBusy()) return;
-
-    LedPattern pattern;
-    memcpy_P(&pattern, &error_patterns[current_error], sizeof(LedPattern));
+    if (current_error == (ErrorCode)-1) return;
 
     const unsigned long now = millis();
-    const float invFreq = 1000.0f / pattern.frequency;
-    const float t1 = invFreq / (1.0f + pattern.ratio);
-    const float t2 = t1 * pattern.ratio;
+    const uint16_t phase = showing_first_color ? current_pattern.t1 : current_pattern.t2;
+    if (now - last_update_time < phase) return;
+    last_update_time = now;
 
     if (showing_first_color) {
-        if (now - last_update_time >= (unsigned long)t1) {
-            LedManager_SetColor(pattern.r2, pattern.g2, pattern.b2);
-            showing_first_color = false;
-            last_update_time = now;
-        }
+        LedManager_SetColor(current_pattern.r2, current_pattern.g2, current_pattern.b2);
+        showing_first_color = false;
     } else {
-        if (now - last_update_time >= (unsigned long)t2) {
-            LedManager_SetColor(pattern.r1, pattern.g1, pattern.b1);
-            showing_first_color = true;
-            last_update_time = now;
-            if (++cycles_done >= MAX_CYCLES) LedManager_Clear();
-        }
+        LedManager_SetColor(current_pattern.r1, current_pattern.g1, current_pattern.b1);
+        showing_first_color = true;
+        if (++cycles_done >= MAX_CYCLES) nextPattern();
     }
 }
@@ -8,10 +8,17 @@
 typedef struct {
     uint8_t r1, g1, b1;
     uint8_t r2, g2, b2;
-    float frequency;
-    float ratio;
+    uint16_t t1, t2;   // duree de chaque couleur (ms)
 } LedPattern;
 
+// Pattern decrit par sa frequence (Hz) et le rapport duree couleur 2 / couleur 1.
+// Les durees sont calculees a la compilation : aucun flottant a l'execution.
+#define LED_PATTERN(r1, g1, b1, r2, g2, b2, frequency, ratio) \
+    { r1, g1, b1, r2, g2, b2, \
+      (uint16_t)(1000.0 / (frequency) / (1.0 + (ratio))), \
+      (uint16_t)(1000.0 / (frequency) / (1.0 + (ratio)) * (ratio)) }
+
+// L'ordre fixe la priorite : les erreurs en attente sont signalees de la premiere a la derniere
 typedef enum : uint8_t {
     ERROR_RTC_ACCESS,
     ERROR_GPS_ACCESS,
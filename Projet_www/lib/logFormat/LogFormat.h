@@ -0,0 +1,94 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+// Format binaire des fichiers journaux (AAMMJJrr.BIN, rr : revision du jour en base 36).
+// Ce fichier ne depend pas d'Arduino : il est aussi utilise par l'outil
+// de decodage sur PC (tools/logdecode). Toutes les valeurs sont en
+// little-endian, comme sur l'AVR.
+
+#include <stdint.h>
+
+#define LOG_MAGIC_0 'W'
+#define LOG_MAGIC_1 'W'
+#define LOG_MAGIC_2 'W'
+#define LOG_MAGIC_3 'L'
+#define LOG_SCHEMA_VERSION 3   // 1 : un LogRecord par acquisition, 2 : un LogSummary par fenetre,
+                               // 3 : LogSummary encadre (LogFrameHead ... crc)
+
+// --- Bits d'erreur (LogRecord.errors) ---
+#define LOG_ERR_TEMP   0x01
+#define LOG_ERR_HYGR   0x02
+#define LOG_ERR_PRESS  0x04
+#define LOG_ERR_LUMIN  0x08
+#define LOG_ERR_GPS    0x10   // pas de position valide
+#define LOG_ERR_COUNT  5
+
+// --- En-tete, ecrit une fois au debut de chaque fichier ---
+struct __attribute__((packed)) LogFileHeader {
+  char magic[4];           // "WWWL"
+  uint8_t version;         // LOG_SCHEMA_VERSION
+  uint8_t recordSize;      // sizeof(LogRecord) (v1) ou sizeof(LogSummary) (v2)
+  uint16_t stationId;
+  uint32_t startTime;      // secondes depuis 2000-01-01 00:00:00
+};
+
+// --- Echantillon, un par acquisition (enregistrement des fichiers v1) ---
+struct __attribute__((packed)) LogRecord {
+  uint32_t time;           // secondes depuis 2000-01-01 00:00:00
+  int16_t temperature;     // centiemes de °C
+  uint16_t humidity;       // centiemes de %RH
+  uint16_t pressure;       // dixiemes de hPa
+  uint16_t luminosity;     // 0..1023
+  uint8_t errors;          // LOG_ERR_*
+  int32_t lat;             // millioniemes de degre
+  int32_t lon;             // millioniemes de degre
+};
+
+// --- Resume d'une fenetre d'acquisitions (enregistrement des fichiers v2) ---
+#define LOG_MIN  0
+#define LOG_MEAN 1
+#define LOG_MAX  2
+
+struct __attribute__((packed)) LogSummary {
+  uint32_t time;                  // premier echantillon de la fenetre
+  uint8_t count;                  // echantillons agreges
+  int16_t temperature[3];         // LOG_MIN / LOG_MEAN / LOG_MAX, memes unites que LogRecord
+  uint16_t humidity[3];
+  uint16_t pressure[3];
+  uint16_t luminosity[3];
+  uint8_t errors[LOG_ERR_COUNT];  // echantillons portant chaque bit LOG_ERR_* (bit 0 en premier)
+  int32_t lat;                    // derniere position valide de la fenetre
+  int32_t lon;
+};
+
+// --- Trame d'un enregistrement (v3) ---
+// LogFrameHead, LogSummary, extension eventuelle, puis uint16_t crc :
+// CRC16-CCITT (lib/crc16) de tous les octets precedents de la trame.
+// recordSize couvre la trame entiere. Apres une coupure, la fin de fichier
+// non valide est remplie de 0 au demarrage : un lecteur qui trouve une trame
+// invalide avance d'un octet et cherche le LOG_SYNC suivant.
+#define LOG_SYNC 0xA5
+
+struct __attribute__((packed)) LogFrameHead {
+  uint8_t sync;            // LOG_SYNC
+  uint16_t seq;            // numero de sequence, continu d'un fichier a l'autre
+};
+
+// Journal texte : chaque ligne se termine par ";seq:<n>;crc:<XXXX>\n", le
+// CRC16-CCITT (4 chiffres hexadecimaux) couvrant la ligne jusqu'a ";crc:"
+// inclus. La fin non valide est remplie de '\n' (lignes vides).
+
+// Un fichier peut declarer recordSize plus grand que son enregistrement : les
+// octets en plus le suivent (avant le crc en v3). Extension de 2 octets :
+// uint16_t octets de pile jamais utilises (firmware avec LOG_MEMORY_WATERMARK).
+
+// --- Index clairseme (AAMMJJrr.IDX, a cote de chaque journal .LOG ou .BIN) ---
+// Entrees triees par offset, au plus une tous les LOG_INDEX_SPACING octets du
+// journal, toujours une pour le premier enregistrement ecrit apres l'ouverture.
+// N'est ecrit qu'apres les donnees qu'il designe.
+struct __attribute__((packed)) LogIndexEntry {
+  uint32_t time;           // horodatage de l'enregistrement a cet offset
+  uint32_t offset;         // debut d'enregistrement (ou de ligne) dans le journal
+};
+
+#endif // LOG_FORMAT_H
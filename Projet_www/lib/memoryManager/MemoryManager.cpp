@@ -0,0 +1,67 @@
+#include "MemoryManager.h"
+
+#define STACK_CANARY 0xC5
+
+extern uint8_t __heap_start;
+extern uint8_t *__brkval;
+
+static uint16_t minFree = 0xFFFF;
+
+// --- Fin actuelle du tas (ou de .bss si malloc n'a jamais servi) ---
+static uint8_t *heapEnd() {
+  return __brkval ? __brkval : &__heap_start;
+}
+
+// --- Peinture de la pile, avant toute initialisation C (section .init1) ---
+// Toute la RAM au-dessus de .bss recoit STACK_CANARY ; les octets encore
+// intacts plus tard n'ont jamais ete atteints par la pile. En assembleur car
+// la pile et le registre zero ne sont pas encore en place a ce stade.
+#ifdef __AVR__
+static void paintStack() __attribute__((naked, used, section(".init1")));
+static void paintStack() {
+  __asm volatile (
+    "    ldi r30, lo8(_end)       \n"
+    "    ldi r31, hi8(_end)       \n"
+    "    ldi r24, %0              \n"
+    "    ldi r25, hi8(__stack)    \n"
+    "    rjmp 2f                  \n"
+    "1:  st Z+, r24               \n"
+    "2:  cpi r30, lo8(__stack)    \n"
+    "    cpc r31, r25             \n"
+    "    brlo 1b                  \n"
+    "    breq 1b                  \n"
+    :: "M" (STACK_CANARY));
+}
+#endif
+
+uint16_t MemoryManager_FreeRam() {
+  uint8_t top;
+  return (uint16_t)(&top - heapEnd());
+}
+
+uint16_t MemoryManager_MinFreeRam() {
+  return minFree;
+}
+
+uint16_t MemoryManager_StackHighWater() {
+  const uint8_t *p = heapEnd();
+  uint16_t n = 0;
+  while (p + n < (const uint8_t *)SP && p[n] == STACK_CANARY) n++;
+  return n;
+}
+
+// --- Appele depuis la boucle principale : cout constant ---
+void MemoryManager_Sample() {
+  uint16_t f = MemoryManager_FreeRam();
+  if (f < minFree) minFree = f;
+}
+
+void MemoryManager_PrintStats() {
+  MemoryManager_Sample();
+  Serial.println(F("=== Memoire ==="));
+  Serial.print(F("RAM libre: ")); Serial.println(MemoryManager_FreeRam());
+  Serial.print(F("RAM libre min: ")); Serial.println(minFree);
+  Serial.print(F("Pile jamais utilisee: ")); Serial.println(MemoryManager_StackHighWater());
+  Serial.print(F("Tas: ")); Serial.println((uint16_t)(heapEnd() - &__heap_start));
+  Serial.println(F("==============="));
+}
@@ -0,0 +1,18 @@
+#ifndef MEMORY_MANAGER_H
+#define MEMORY_MANAGER_H
+
+#include <Arduino.h>
+
+// Ajoute le point bas de RAM libre a chaque enregistrement du journal
+#ifndef LOG_MEMORY_WATERMARK
+#define LOG_MEMORY_WATERMARK 0
+#endif
+
+// --- Fonctions publiques ---
+uint16_t MemoryManager_FreeRam();        // espace libre actuel entre tas et pile
+uint16_t MemoryManager_MinFreeRam();     // plus bas espace libre echantillonne
+uint16_t MemoryManager_StackHighWater(); // octets de pile jamais touches depuis le demarrage
+void MemoryManager_Sample();
+void MemoryManager_PrintStats();
+
+#endif // MEMORY_MANAGER_H
@@ -0,0 +1,113 @@
+// Sommeil du mode economique.
+//
+// Le MCU passe en mode IDLE entre deux interruptions utiles : Timer1 (1 Hz),
+// boutons (INT0/INT1) et reception serie. L'interruption Timer0 de millis()
+// est masquee pendant le sommeil, sinon elle reveillerait le MCU toutes les
+// millisecondes ; la duree du sommeil est mesuree sur Timer1 et ajoutee a
+// millis() au reveil. Les ISR qui reveillent le MCU s'executent avant cette
+// correction : elles horodatent avec PowerManager_Millis(). ADC, SPI et TWI
+// sont coupes pendant le sommeil.
+
+#include "PowerManager.h"
+#include <avr/sleep.h>
+#include <avr/power.h>
+
+// Compteur de millis() du coeur Arduino (wiring.c)
+extern volatile unsigned long timer0_millis;
+
+#define TIMER1_STEPS_PER_TICK 15625UL   // OCR1A + 1, un pas = 64 µs
+
+static volatile uint16_t timer1Ticks = 0;
+static uint32_t sleepMs = 0;
+static uint32_t sleepCount = 0;
+static uint8_t remainderUnits = 0;      // fraction de milliseconde reportee (pas de 8 µs)
+
+// --- Sommeil en cours (Timer0 arrete) ---
+static volatile bool sleeping = false;
+static uint16_t sleepTicks0 = 0;
+static uint16_t sleepCount0 = 0;
+
+// Duree du sommeil en unites de 8 µs, interruptions masquees ; une comparaison
+// Timer1 encore en attente compte aussi
+static uint32_t sleptUnits() {
+  uint32_t steps = (uint32_t)(uint16_t)(timer1Ticks - sleepTicks0) * TIMER1_STEPS_PER_TICK + TCNT1 - sleepCount0;
+  if (TIFR1 & _BV(OCF1A)) steps += TIMER1_STEPS_PER_TICK;
+  return steps * 8 + remainderUnits;   // 1 pas Timer1 = 64 µs
+}
+
+void PowerManager_Init() {
+  // Timer2 n'est utilise par aucun module. Les boutons reveillent le MCU
+  // par leurs propres interruptions (ButtonManager).
+  power_timer2_disable();
+  Serial.println(F("[INFO] PowerManager initialisé"));
+}
+
+void PowerManager_OnTimer1Tick() {
+  timer1Ticks++;
+}
+
+// --- Dort jusqu'a la prochaine interruption, sauf si pending est deja leve ---
+bool PowerManager_Sleep(volatile uint8_t &pending) {
+  noInterrupts();
+  if (pending) {
+    interrupts();
+    return false;
+  }
+
+  sleepTicks0 = timer1Ticks;
+  sleepCount0 = TCNT1;
+  sleeping = true;
+
+  uint8_t adcsra = ADCSRA;
+  ADCSRA &= ~_BV(ADEN);
+  power_adc_disable();
+  power_spi_disable();
+  power_twi_disable();
+  TIMSK0 &= ~_BV(TOIE0);
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  interrupts();
+  sleep_cpu();
+  sleep_disable();
+  noInterrupts();
+
+  uint32_t units = sleptUnits();
+  uint32_t ms = units / 125;
+  remainderUnits = units % 125;
+  timer0_millis += ms;
+  sleeping = false;
+  sleepMs += ms;
+  sleepCount++;
+
+  TIFR0 = _BV(TOV0);
+  TIMSK0 |= _BV(TOIE0);
+  power_twi_enable();
+  power_spi_enable();
+  power_adc_enable();
+  ADCSRA = adcsra;
+  interrupts();
+  return true;
+}
+
+// --- millis() sans retard pendant le sommeil ---
+unsigned long PowerManager_Millis() {
+  uint8_t sreg = SREG;
+  noInterrupts();
+  unsigned long ms = millis();
+  if (sleeping) ms += sleptUnits() / 125;
+  SREG = sreg;
+  return ms;
+}
+
+void PowerManager_PrintStats() {
+  uint32_t total = millis();
+  uint32_t active = total - sleepMs;
+  Serial.println(F("=== Energie ==="));
+  Serial.print(F("Actif (ms): ")); Serial.println(active);
+  Serial.print(F("Sommeil (ms): ")); Serial.println(sleepMs);
+  Serial.print(F("Mises en sommeil: ")); Serial.println(sleepCount);
+  Serial.print(F("Cycle actif (%): "));
+  Serial.println(total >= 100 ? active / (total / 100) : 100);
+  Serial.println(F("==============="));
+}
@@ -0,0 +1,13 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// --- Fonctions publiques ---
+void PowerManager_Init();
+void PowerManager_OnTimer1Tick();              // depuis ISR(TIMER1_COMPA_vect)
+bool PowerManager_Sleep(volatile uint8_t &pending);   // pending != 0 : pas de sommeil ; true si dormi
+unsigned long PowerManager_Millis();           // millis(), sommeil en cours compris (utilisable en ISR)
+void PowerManager_PrintStats();
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,129 @@
+#include "RecordFormatter.h"
+#include <avr/pgmspace.h>
+
+// --- Description des champs, en memoire flash ---
+// Meme ordre et meme nombre de decimales pour la ligne SD et l'affichage maintenance.
+enum Field : uint8_t { F_TEMP, F_HYGR, F_LUMIN, F_PRESS, F_LAT, F_LON, FIELD_COUNT };
+
+static const char keyTemp[] PROGMEM  = "temperature";
+static const char keyHygr[] PROGMEM  = "humidity";
+static const char keyLumin[] PROGMEM = "luminosity";
+static const char keyPress[] PROGMEM = "pressure";
+static const char keyLat[] PROGMEM   = "lat";
+static const char keyLon[] PROGMEM   = "lon";
+
+static const char lblTemp[] PROGMEM  = "| Temperature :  ";
+static const char lblHygr[] PROGMEM  = "| Humidite :     ";
+static const char lblLumin[] PROGMEM = "| Luminosite :   ";
+static const char lblPress[] PROGMEM = "| Pression :     ";
+static const char lblLat[] PROGMEM   = "| Lat :          ";
+static const char lblLon[] PROGMEM   = "L Lon :          ";
+
+struct FieldDesc {
+  const char *key;
+  const char *label;
+  uint8_t decimals;
+};
+
+static const FieldDesc fields[FIELD_COUNT] PROGMEM = {
+  {keyTemp,  lblTemp,  2},
+  {keyHygr,  lblHygr,  2},
+  {keyLumin, lblLumin, 0},
+  {keyPress, lblPress, 1},
+  {keyLat,   lblLat,   6},
+  {keyLon,   lblLon,   6}
+};
+
+static int32_t fieldValue(const LogRecord &r, uint8_t f) {
+  switch (f) {
+    case F_TEMP:  return r.temperature;
+    case F_HYGR:  return r.humidity;
+    case F_LUMIN: return r.luminosity;
+    case F_PRESS: return r.pressure;
+    case F_LAT:   return r.lat;
+    default:      return r.lon;
+  }
+}
+
+static int32_t summaryValue(const LogSummary &s, uint8_t f, uint8_t which) {
+  switch (f) {
+    case F_TEMP:  return s.temperature[which];
+    case F_HYGR:  return s.humidity[which];
+    case F_LUMIN: return s.luminosity[which];
+    case F_PRESS: return s.pressure[which];
+    case F_LAT:   return s.lat;
+    default:      return s.lon;
+  }
+}
+
+static const __FlashStringHelper *flash(const char *p) {
+  return reinterpret_cast<const __FlashStringHelper *>(p);
+}
+
+// --- Nombre en virgule fixe : value / 10^decimals, sans float ---
+size_t RecordFormatter_PrintFixed(Print &out, int32_t value, uint8_t decimals) {
+  char tmp[12];
+  uint8_t n = 0;
+  uint32_t u = value < 0 ? 0UL - (uint32_t)value : (uint32_t)value;
+
+  do {
+    tmp[n++] = '0' + u % 10;
+    u /= 10;
+    if (n == decimals) tmp[n++] = '.';
+  } while (u || n < (decimals ? decimals + 2 : 1));
+  if (value < 0) tmp[n++] = '-';
+
+  size_t written = 0;
+  while (n) written += out.write(tmp[--n]);
+  return written;
+}
+
+// --- Ligne du journal texte ---
+// Un echantillon : time:...;temperature:...;...;lon:...[;errors:masque LOG_ERR_*]
+// Une fenetre : time:...;count:N;temperature:moy;temperature_min:...;temperature_max:...;
+//               ...;lat:...;lon:...[;errors:t,h,p,l,g] (echantillons par bit d'erreur)
+size_t RecordFormatter_WriteSummary(Print &out, const LogSummary &summary) {
+  bool window = summary.count > 1;
+  size_t n = out.print(F("time:"));
+  n += out.print(summary.time);
+  if (window) {
+    n += out.print(F(";count:"));
+    n += out.print(summary.count);
+  }
+
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    const __FlashStringHelper *key = flash((const char *)pgm_read_ptr(&fields[f].key));
+    uint8_t decimals = pgm_read_byte(&fields[f].decimals);
+    n += out.write(';');
+    n += out.print(key);
+    n += out.write(':');
+    n += RecordFormatter_PrintFixed(out, summaryValue(summary, f, LOG_MEAN), decimals);
+    if (window && f < F_LAT) {
+      n += out.write(';'); n += out.print(key); n += out.print(F("_min:"));
+      n += RecordFormatter_PrintFixed(out, summaryValue(summary, f, LOG_MIN), decimals);
+      n += out.write(';'); n += out.print(key); n += out.print(F("_max:"));
+      n += RecordFormatter_PrintFixed(out, summaryValue(summary, f, LOG_MAX), decimals);
+    }
+  }
+
+  uint8_t mask = 0;
+  for (uint8_t b = 0; b < LOG_ERR_COUNT; b++) if (summary.errors[b]) mask |= 1 << b;
+  if (!mask) return n;
+
+  n += out.print(F(";errors:"));
+  if (!window) return n + out.print(mask);
+  for (uint8_t b = 0; b < LOG_ERR_COUNT; b++) {
+    if (b) n += out.write(',');
+    n += out.print(summary.errors[b]);
+  }
+  return n;
+}
+
+// --- Affichage du mode maintenance ---
+void RecordFormatter_PrintMaintenance(Print &out, const LogRecord &record) {
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    out.print(flash((const char *)pgm_read_ptr(&fields[f].label)));
+    RecordFormatter_PrintFixed(out, fieldValue(record, f), pgm_read_byte(&fields[f].decimals));
+    out.println();
+  }
+}
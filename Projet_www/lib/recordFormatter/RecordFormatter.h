@@ -0,0 +1,17 @@
+#ifndef RECORD_FORMATTER_H
+#define RECORD_FORMATTER_H
+
+#include <Arduino.h>
+#include <LogFormat.h>
+
+// Longueur maximale d'une ligne de journal texte, sans '\n' (pire cas : chaque
+// champ a sa valeur extreme)
+#define RECORD_SUMMARY_MAX 325     // fenetre agregee (count > 1)
+#define RECORD_SAMPLE_MAX 128      // echantillon seul (count = 1)
+
+// --- Fonctions publiques ---
+size_t RecordFormatter_PrintFixed(Print &out, int32_t value, uint8_t decimals);
+size_t RecordFormatter_WriteSummary(Print &out, const LogSummary &summary);
+void RecordFormatter_PrintMaintenance(Print &out, const LogRecord &record);
+
+#endif // RECORD_FORMATTER_H
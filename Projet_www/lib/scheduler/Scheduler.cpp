@@ -0,0 +1,113 @@
+#include "Scheduler.h"
+#include <PowerManager.h>
+
+struct Task {
+  TaskFn fn;
+  const char *name;          // en memoire flash
+  uint16_t period;           // ms, 0 = tache evenementielle
+  uint16_t deadline;         // ms entre la liberation et la fin de l'execution
+  unsigned long nextRun;     // prochaine liberation (taches periodiques)
+  // --- Statistiques depuis le dernier affichage ---
+  uint16_t runs;
+  uint16_t missed;
+  uint16_t maxLatency;       // ms entre la liberation et le debut
+  uint32_t maxRunUs;
+  uint32_t totalRunUs;
+};
+
+static Task tasks[SCHEDULER_MAX_TASKS];
+static uint8_t taskCount = 0;
+
+static volatile uint8_t pendingEvents = 0;
+static volatile unsigned long eventRelease[SCHEDULER_MAX_TASKS];
+static unsigned long statsSince = 0;
+
+uint8_t Scheduler_AddTask(const char *name, TaskFn fn, uint16_t periodMs, uint16_t deadlineMs) {
+  if (taskCount >= SCHEDULER_MAX_TASKS) return 0xFF;
+  Task &t = tasks[taskCount];
+  t.fn = fn;
+  t.name = name;
+  t.period = periodMs;
+  t.deadline = deadlineMs;
+  t.nextRun = millis();
+  return taskCount++;
+}
+
+void Scheduler_Trigger(uint8_t id) {
+  if (id >= taskCount) return;
+  uint8_t sreg = SREG;
+  noInterrupts();
+  // Garde la premiere liberation si l'evenement est deja en attente
+  if (!(pendingEvents & (1 << id))) {
+    pendingEvents |= (1 << id);
+    // Depuis une ISR de reveil, millis() n'est pas encore corrige du sommeil
+    eventRelease[id] = PowerManager_Millis();
+  }
+  SREG = sreg;
+}
+
+volatile uint8_t &Scheduler_PendingEvents() {
+  return pendingEvents;
+}
+
+void Scheduler_Run() {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Task &t = tasks[i];
+    unsigned long now = millis();
+    unsigned long release;
+
+    if (t.period) {
+      if ((long)(now - t.nextRun) < 0) continue;
+      release = t.nextRun;
+      t.nextRun += t.period;
+      // En retard de plus d'une periode : on repart de maintenant, sans rafale
+      if ((long)(now - t.nextRun) >= 0) t.nextRun = now + t.period;
+    } else {
+      if (!(pendingEvents & (1 << i))) continue;
+      noInterrupts();
+      pendingEvents &= ~(1 << i);
+      release = eventRelease[i];
+      interrupts();
+    }
+
+    unsigned long start = micros();
+    t.fn();
+    unsigned long runUs = micros() - start;
+
+    unsigned long latency = now - release;
+    if (latency > t.maxLatency) t.maxLatency = latency > 0xFFFF ? 0xFFFF : latency;
+    if (runUs > t.maxRunUs) t.maxRunUs = runUs;
+    t.totalRunUs += runUs;
+    t.runs++;
+    if (latency + runUs / 1000 > t.deadline) t.missed++;
+  }
+}
+
+// --- Reveil : les liberations echues pendant le sommeil comptent du reveil ---
+void Scheduler_OnWake() {
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Task &t = tasks[i];
+    if (t.period && (long)(now - t.nextRun) > 0) t.nextRun = now;
+  }
+}
+
+// --- Affiche puis remet a zero les statistiques ---
+void Scheduler_PrintStats() {
+  unsigned long window = millis() - statsSince;
+  Serial.print(F("=== Taches (sur ")); Serial.print(window / 1000); Serial.println(F(" s) ==="));
+  Serial.println(F("nom: executions, retard max ms, duree max us, charge %, echeances ratees"));
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Task &t = tasks[i];
+    Serial.print(reinterpret_cast<const __FlashStringHelper *>(t.name)); Serial.print(F(": "));
+    Serial.print(t.runs); Serial.print(F(", "));
+    Serial.print(t.maxLatency); Serial.print(F(", "));
+    Serial.print(t.maxRunUs); Serial.print(F(", "));
+    Serial.print(window ? t.totalRunUs / 10 / window : 0); Serial.print(F(", "));
+    Serial.println(t.missed);
+    t.runs = t.missed = t.maxLatency = 0;
+    t.maxRunUs = t.totalRunUs = 0;
+  }
+  Serial.println(F("======================="));
+  statsSince = millis();
+}
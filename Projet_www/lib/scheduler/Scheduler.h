@@ -0,0 +1,24 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Ordonnanceur cooperatif a table statique. Une tache est soit periodique
+// (periodMs > 0), soit declenchee par un evenement (periodMs == 0, voir
+// Scheduler_Trigger). Les taches pretes s'executent dans l'ordre
+// d'enregistrement, qui sert de priorite. Pendant le sommeil du mode eco,
+// les taches periodiques sont suspendues : elles repartent du reveil.
+
+#define SCHEDULER_MAX_TASKS 8
+
+typedef void (*TaskFn)();
+
+// --- Fonctions publiques ---
+uint8_t Scheduler_AddTask(const char *name /* PROGMEM */, TaskFn fn, uint16_t periodMs, uint16_t deadlineMs);
+void Scheduler_Trigger(uint8_t id);            // utilisable depuis une ISR
+void Scheduler_Run();
+void Scheduler_OnWake();                       // apres un PowerManager_Sleep() effectif
+volatile uint8_t &Scheduler_PendingEvents();   // masque des evenements en attente
+void Scheduler_PrintStats();
+
+#endif // SCHEDULER_H
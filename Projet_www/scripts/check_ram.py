@@ -0,0 +1,30 @@
+# Verifie apres l'edition de liens que la RAM statique (.data + .bss) reste
+# sous la limite custom_ram_limit de platformio.ini. Le reste de la RAM est
+# laisse a la pile : au-dela, la station redemarre au hasard sur le terrain.
+
+import re
+import subprocess
+
+Import("env")
+
+
+def check_ram(source, target, env):
+    limit = int(env.GetProjectOption("custom_ram_limit", "0"))
+    if not limit:
+        return
+
+    elf = target[0].get_abspath()
+    out = subprocess.check_output([env.subst("$SIZETOOL"), "-A", elf]).decode()
+    used = 0
+    for name in (".data", ".bss", ".noinit"):
+        m = re.search(r"^\%s\s+(\d+)" % name, out, re.M)
+        if m:
+            used += int(m.group(1))
+
+    print("RAM statique : %d / %d octets" % (used, limit))
+    if used > limit:
+        print("[ERROR] RAM statique au-dessus de custom_ram_limit (%d > %d)" % (used, limit))
+        env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_ram)
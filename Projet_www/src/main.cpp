@@ -4,14 +4,29 @@
 #include <ConfigManager.h>
 #include <clockManager.h>
 #include <fileManager.h>
+#include <RecordFormatter.h>
+#include <MemoryManager.h>
+#include <PowerManager.h>
+#include <Scheduler.h>
+#include <ButtonManager.h>
+#include <ErrorJournal.h>
+#include <Aggregator.h>
 #include <Wire.h>
-#include <clockManager.h>
 
 #define BTN_ROUGE 2
 #define BTN_VERT 3
 
-//Permet d'utiliser les capteurs ou la SD sans faire deborder la RAM
-#define USE_SD 0
+// Index des boutons dans ButtonManager
+#define BOUTON_ROUGE 0
+#define BOUTON_VERT 1
+
+// Reveil du GPS avant une acquisition en mode economique (secondes)
+#define GPS_WARMUP_S 10
+
+// Journalisation sur carte SD (0 = capteurs seuls, affichage serie)
+#ifndef USE_SD
+#define USE_SD 1
+#endif
 
 
 enum Mode : uint8_t {
@@ -25,30 +40,49 @@ enum Mode : uint8_t {
 
 struct ModeInfo {
   uint8_t r, g, b;
-  const char* msg;
+  const char* msg;   // en memoire flash
 };
 
-const ModeInfo modeInfo[] = {
-  {0, 0, 0,   "[INFO] Mode Veille (LED eteinte)"},
-  {0, 255, 0, "[INFO] Mode Standard actif"},
-  {255, 255, 0, "[INFO] Mode Configuration actif (3 min max)"},
-  {255, 80, 0, "[INFO] Mode Maintenance actif"},
-  {0, 0, 255, "[INFO] Mode economique actif"}
+static const char msgEteint[] PROGMEM = "[INFO] Mode Veille (LED eteinte)";
+static const char msgStandard[] PROGMEM = "[INFO] Mode Standard actif";
+static const char msgConfig[] PROGMEM = "[INFO] Mode Configuration actif (3 min max)";
+static const char msgMaintenance[] PROGMEM = "[INFO] Mode Maintenance actif";
+static const char msgEco[] PROGMEM = "[INFO] Mode economique actif";
+
+const ModeInfo modeInfo[] PROGMEM = {
+  {0, 0, 0,   msgEteint},
+  {0, 255, 0, msgStandard},
+  {255, 255, 0, msgConfig},
+  {255, 80, 0, msgMaintenance},
+  {0, 0, 255, msgEco}
 };
 
 
 Mode mode = MODE_ETEINT;
 Mode previousMode = MODE_STANDARD;
-unsigned long timerRougeStart = 0, timerVertStart = 0;
-bool rougeHeldDone = false, vertHeldDone = false;
 
 volatile bool retourAutoFlag = false;
 
-volatile bool aquireDataFlag = false;
+// --- Taches de l'ordonnanceur (l'ordre d'enregistrement fixe la priorite) ---
+static const char taskNameAcquisition[] PROGMEM = "acquisition";
+static const char taskNameButtons[] PROGMEM = "boutons";
+static const char taskNameLed[] PROGMEM = "led";
+static const char taskNameGps[] PROGMEM = "gps";
+static const char taskNameGpsWake[] PROGMEM = "reveil gps";
+static const char taskNameConsole[] PROGMEM = "console";
+static const char taskNameFlush[] PROGMEM = "vidage sd";
+static const char taskNameHousekeeping[] PROGMEM = "entretien";
+
+uint8_t taskAcquisition, taskGpsWake;
 
 volatile unsigned int secondesData = 0;
 
-const unsigned int LOG_INTERVAL = 10;
+// --- Derive de la configuration (LOG_INTERVAL), relu quand sa version change ---
+// Une nouvelle periode n'est adoptee qu'a la limite d'un echantillon.
+volatile unsigned int logInterval = 10;
+volatile unsigned int nextLogInterval = 10;
+uint8_t configVersion = 0;
+uint8_t aggWindow = 1;         // AGG_WINDOW : acquisitions par enregistrement SD
 
 
 void initPins();
@@ -56,12 +90,24 @@ void setMode(Mode newMode);
 void handleDataAcquisition();
 void configTimer1();
 void handleButtons();
+void refreshConfig();
+bool isEcoActive();
+void ecoSleep();
+void setupTasks();
+void acquisitionTask();
+void gpsWakeTask();
+void consoleTask();
+void housekeepingTask();
+void fillRecord(LogRecord& record, const SensorData& data, bool gpsOk, int32_t lat, int32_t lon);
 
 void setup() {
-  Serial.begin(9600);
+  Serial.begin(CONSOLE_BAUD);
   initPins();
+  PowerManager_Init();
   LedManager_Init(5,6);
   ConfigManager_init();
+  ErrorJournal_Init();
+  refreshConfig();
   configTimer1();
   init_clock();
   setMode(MODE_ETEINT);
@@ -69,97 +115,131 @@ void setup() {
 
 
 
+  init_capteur();
 #if USE_SD == 1
   init_SD();
-#elif USE_SD == 0
-  init_capteur();
 #endif
 
-
-
+  setupTasks();
 }
 
 void loop() {
-  LedManager_Update();
-  handleButtons();
+  Scheduler_Run();
+  ecoSleep();
+}
 
-  if (mode == MODE_ETEINT) {
-    if (digitalRead(BTN_ROUGE) == LOW) setMode(MODE_CONFIG);
-    else if (digitalRead(BTN_VERT) == LOW) setMode(MODE_STANDARD);
-    return;
-  }
+void setupTasks() {
+  // Periode 0 : tache declenchee par un evenement (Timer1). Echeances en ms.
+  taskAcquisition = Scheduler_AddTask(taskNameAcquisition, acquisitionTask, 0, 1000);
+  Scheduler_AddTask(taskNameButtons, handleButtons, 20, 50);
+  Scheduler_AddTask(taskNameLed, LedManager_Update, 10, 20);
+  Scheduler_AddTask(taskNameGps, CapteurManager_UpdateGPS, 20, 60);
+  taskGpsWake = Scheduler_AddTask(taskNameGpsWake, gpsWakeTask, 0, 100);
+  Scheduler_AddTask(taskNameConsole, consoleTask, 20, 100);
+#if USE_SD == 1
+  Scheduler_AddTask(taskNameFlush, FileManager_Update, 1000, 1000);
+#endif
+  Scheduler_AddTask(taskNameHousekeeping, housekeepingTask, 100, 200);
+}
 
-  if(mode == MODE_CONFIG)
-  {
- 
-    if (retourAutoFlag) {
-      retourAutoFlag = false;
-      setMode(MODE_STANDARD);
-    }
-    else 
-    {
-      ConfigManager_Update();
+void acquisitionTask() {
+  if (mode != MODE_CONFIG && mode != MODE_ETEINT) handleDataAcquisition();
+}
 
-    }
+void gpsWakeTask() {
+  CapteurManager_GPSStandby(false);
+}
 
+// --- Console serie, disponible dans tous les modes actifs ---
+void consoleTask() {
+  if (mode == MODE_ETEINT) return;
+
+  if (mode == MODE_CONFIG && retourAutoFlag) {
+    retourAutoFlag = false;
+    setMode(MODE_STANDARD);
+  }
+  else
+  {
+    ConfigManager_Update(mode == MODE_CONFIG);
   }
+}
 
+void housekeepingTask() {
+  MemoryManager_Sample();
+  ErrorJournal_Update();
+  Clock_Update();
+  refreshConfig();
+}
 
-  if (aquireDataFlag && mode != MODE_CONFIG && mode != MODE_ETEINT)
-    handleDataAcquisition();
+bool isEcoActive() {
+  return mode == MODE_ECO;
 }
 
+// --- Sommeil entre deux ticks Timer1 en mode economique ---
+void ecoSleep() {
+  if (!isEcoActive()) return;
+  // Pas de sommeil tant qu'un appui, un pattern LED ou une commande est en cours :
+  // ils ont besoin de millis() et d'un loop() rapide
+  if (ButtonManager_AnyHeld()) return;
+  if (LedManager_IsBusy() || Serial.available()) return;
+  if (PowerManager_Sleep(Scheduler_PendingEvents())) Scheduler_OnWake();
+}
+
+// --- Actions des boutons, fronts captures par interruption ---
 void handleButtons() {
-  unsigned long now = millis();
+  ButtonManager_Update();
+  uint8_t rouge = ButtonManager_Take(BOUTON_ROUGE);
+  uint8_t vert = ButtonManager_Take(BOUTON_VERT);
 
-  if (digitalRead(BTN_ROUGE) == LOW) {
-    if (timerRougeStart == 0) timerRougeStart = now;
-    if (!rougeHeldDone && now - timerRougeStart > 5000) 
-    {
-      rougeHeldDone = true;
-      if (mode == MODE_MAINTENANCE) setMode(previousMode);
-      else 
-      { 
-        previousMode = mode; 
-        setMode(MODE_MAINTENANCE); 
-      }
-    }
-  } else 
-  {
-    timerRougeStart = 0;
-    rougeHeldDone = false;
+  if (mode == MODE_ETEINT) {
+    if (rouge & BUTTON_PRESS) setMode(MODE_CONFIG);
+    else if (vert & BUTTON_PRESS) setMode(MODE_STANDARD);
+    return;
   }
 
-  if (digitalRead(BTN_VERT) == LOW) 
+  if (rouge & BUTTON_LONG)
   {
-    if (timerVertStart == 0) timerVertStart = now;
-    if (!vertHeldDone && now - timerVertStart > 5000) 
+    if (mode == MODE_MAINTENANCE) setMode(previousMode);
+    else
     {
-      vertHeldDone = true;
-      if (mode == MODE_ECO) setMode(MODE_STANDARD);
-      else if (mode == MODE_STANDARD) setMode(MODE_ECO);
+      previousMode = mode;
+      setMode(MODE_MAINTENANCE);
     }
-  } else 
+  }
+
+  if (vert & BUTTON_LONG)
   {
-    timerVertStart = 0;
-    vertHeldDone = false;
+    if (mode == MODE_ECO) setMode(MODE_STANDARD);
+    else if (mode == MODE_STANDARD) setMode(MODE_ECO);
   }
 }
 
 void setMode(Mode newMode) {
   mode = newMode;
+  if (!isEcoActive()) CapteurManager_GPSStandby(false);
+  noInterrupts();
   secondesEcoulees = 0;
   secondesData = 0;
-  const ModeInfo& info = modeInfo[newMode];
+  logInterval = nextLogInterval;
+  interrupts();
+  ModeInfo info;
+  memcpy_P(&info, &modeInfo[newMode], sizeof(ModeInfo));
   LedManager_SetModeColor(info.r, info.g, info.b);
 
-  Serial.println(info.msg);
+  Serial.println(reinterpret_cast<const __FlashStringHelper*>(info.msg));
 }
 
-void initPins() {
+void refreshConfig() {
+  if (configVersion == ConfigManager_Version()) return;
+  configVersion = ConfigManager_Version();
+  noInterrupts();
+  nextLogInterval = configParams.LOG_INTERVAL;
+  interrupts();
+  aggWindow = configParams.AGG_WINDOW;
+}
 
-  pinMode(BTN_ROUGE, INPUT_PULLUP);
-  pinMode(BTN_VERT, INPUT_PULLUP);
+void initPins() {
+  ButtonManager_Init(BTN_ROUGE, BTN_VERT);
   Serial.println(F("[INFO] Pins initialisés"));
 }
 
@@ -174,6 +254,8 @@ void configTimer1() {
 }
 
 ISR(TIMER1_COMPA_vect) {
+  Clock_Tick();
+  PowerManager_OnTimer1Tick();
   if (mode == MODE_ETEINT) return;
 
   if (mode == MODE_CONFIG) {
@@ -183,100 +265,60 @@ ISR(TIMER1_COMPA_vect) {
       retourAutoFlag = true;
     }
   } else {
-    unsigned int wait_value = (mode == MODE_ECO || (mode == MODE_MAINTENANCE && previousMode == MODE_ECO)) ? LOG_INTERVAL * 4 : LOG_INTERVAL;
+    unsigned int wait_value = (mode == MODE_ECO || (mode == MODE_MAINTENANCE && previousMode == MODE_ECO)) ? logInterval * 4 : logInterval;
     if (++secondesData >= wait_value) {
       secondesData = 0;
-      aquireDataFlag = true;
+      logInterval = nextLogInterval;
+      Scheduler_Trigger(taskAcquisition);
+    }
+    else if (mode == MODE_ECO && wait_value > GPS_WARMUP_S && secondesData == wait_value - GPS_WARMUP_S) {
+      Scheduler_Trigger(taskGpsWake);
     }
   }
 }
 
 void handleDataAcquisition() {
-  aquireDataFlag = false;
-#if USE_SD == 0
 
   SensorData data = readSensors();
-  float lat, lon;
-  readGPS(lat, lon);
-
-  if (mode == MODE_MAINTENANCE){
-    Serial.println("[INFO] Donnees (maintenance): " );
-    Serial.println("| Temperature :  "+String(data.temperature));
-    Serial.println("| Humidite :     "+String(data.humidity));
-    Serial.println("| Luminosite :   "+String(data.luminosity));
-    Serial.println("| Pression :     "+String(data.pressure));
-    Serial.print(F("Lat: ")); Serial.print(lat, 6);
-    Serial.print(F("  Lon: ")); Serial.println(lon, 6);
-  }
-  else
-  {
-    Serial.println("[INFO] Data Sauvergardée sur la carte SD");
-  }
-#elif USE_SD == 1
-
-  SensorData data;
-
-  // Valeurs arbitraires pour simuler une aquisition de donnée
-  data.temperature = 25.0;
-  data.humidity = 50.0;
-  data.pressure = 1013.25;
-  data.luminosity = 500;
+  int32_t lat = 0, lon = 0;
+  bool gpsOk = readGPS(lat, lon);
 
-  float lat, lon;
-  lat = 48.8566;
-  lon = 2.3522;
+  LogRecord record;
+  fillRecord(record, data, gpsOk, lat, lon);
 
-
-  if(mode == MODE_MAINTENANCE)
+  if (mode == MODE_MAINTENANCE)
   {
-    String print_data = 
-      "| Temperature :  "+String(data.temperature)+"\n"+
-      "| Humidite :     "+String(data.humidity)+"\n"+
-      "| Luminosite :   "+String(data.luminosity)+"\n"+
-      "L Pression :     "+String(data.pressure)
-    ;
-    Serial.println("[INFO] Donnees (maintenance): \n" + print_data);
-    Serial.print(F("Lat: ")); Serial.print(lat, 6);
-    Serial.print(F("  Lon: ")); Serial.println(lon, 6);
+    Serial.println(F("[INFO] Donnees (maintenance): "));
+    RecordFormatter_PrintMaintenance(Serial, record);
   }
   else
   {
-    Serial.println("saved data");
-    char datachar[100];
-    char tmpdata[10];
-
-    dtostrf(data.temperature, 6, 2, tmpdata);
-    strcpy(datachar, "temperature:");
-    strcpy(datachar, tmpdata);
-    strcpy(datachar, ";");
-
-    dtostrf(data.humidity, 6, 2, tmpdata);
-    strcpy(datachar, "humidity:");
-    strcpy(datachar, tmpdata);
-    strcpy(datachar, ";");
-
-    itoa(data.luminosity, tmpdata, 10);
-    strcpy(datachar, "luminosity:");
-    strcpy(datachar, tmpdata);
-    strcpy(datachar, ";");
-
-    dtostrf(data.pressure, 6, 2, tmpdata);
-    strcpy(datachar, "pressure:");
-    strcpy(datachar, tmpdata);
-    strcpy(datachar, ";");
-
-    dtostrf(lat, 6, 2, tmpdata);
-    strcpy(datachar, "lat:");
-    strcpy(datachar, tmpdata);
-    strcpy(datachar, "  ");
-    dtostrf(lon, 6, 2, tmpdata);
-    strcpy(datachar, "lon:");
-    strcpy(datachar, tmpdata);
-    strcpy(datachar, "/n");
-
-    saveData(datachar);
+    // Un seul enregistrement par fenetre de AGG_WINDOW acquisitions
+    Aggregator_Add(record);
+    if (Aggregator_Count() >= aggWindow)
+    {
+      LogSummary summary;
+      Aggregator_Take(summary);
+#if USE_SD == 1
+      if (saveSummary(summary)) Serial.println(F("[INFO] Data Sauvergardée sur la carte SD"));
+      else Serial.println(F("[ERROR] Carte SD indisponible, enregistrement mis en attente"));
+#endif
+    }
   }
 
+  // GPS en veille jusqu'au prochain reveil (GPS_WARMUP_S avant l'acquisition)
+  if (isEcoActive()) CapteurManager_GPSStandby(true);
+}
 
-#endif
+void fillRecord(LogRecord& record, const SensorData& data, bool gpsOk, int32_t lat, int32_t lon) {
+  record.time = getTimestamp();
+  record.temperature = data.temperature;
+  record.humidity = data.humidity;
+  record.pressure = data.pressure;
+  record.luminosity = data.luminosity;
+  record.errors = (data.tempError ? LOG_ERR_TEMP : 0) | (data.hygrError ? LOG_ERR_HYGR : 0) |
+                  (data.pressError ? LOG_ERR_PRESS : 0) | (data.luminError ? LOG_ERR_LUMIN : 0) |
+                  (gpsOk ? 0 : LOG_ERR_GPS);
+  record.lat = lat;
+  record.lon = lon;
 }
@@ -0,0 +1,400 @@
+// Coeur simule de env:native : registres, Timer0/Timer1, interruptions
+// externes, sommeil, Serial sur stdin/stdout et programme hote (main).
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <string>
+
+// --- Registres ---
+volatile uint8_t SREG = 0x80;           // init() du coeur Arduino a deja fait sei()
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A;
+volatile uint8_t TIMSK0 = _BV(TOIE0), TIFR0;
+volatile uint8_t ADCSRA = _BV(ADEN), PRR, SMCR, MCUSR;
+
+uint8_t __heap_start;
+uint8_t *__brkval = nullptr;
+
+volatile unsigned long timer0_millis = 0;
+
+// --- Vecteurs d'interruption ---
+extern "C" void TIMER1_COMPA_vect(void) __attribute__((weak));
+
+#define PIN_COUNT 20
+#define INT_COUNT 2
+
+static uint8_t pinLevel[PIN_COUNT];
+static int analogValue[PIN_COUNT];
+static void (*extIsr[INT_COUNT])(void);
+static int extMode[INT_COUNT];
+static bool extPending[INT_COUNT];
+
+// --- Temps materiel ---
+static uint64_t hwMs = 0;
+static uint64_t timer1Cycles = 0;       // cycles CPU (16 MHz) depuis la derniere comparaison
+static uint16_t lastTcnt = 0;
+static uint32_t interruptCount = 0;
+static bool realTime = false;
+
+static struct PinInit {
+  PinInit() {
+    for (uint8_t i = 0; i < PIN_COUNT; i++) { pinLevel[i] = HIGH; analogValue[i] = 512; }
+  }
+} pinInit;
+
+static void callIsr(void (*isr)(void)) {
+  uint8_t sreg = SREG;
+  SREG &= ~0x80;
+  isr();
+  interruptCount++;
+  SREG = sreg;
+}
+
+// --- Interruptions en attente, servies des que SREG les autorise ---
+static void runPending() {
+  if (!(SREG & 0x80)) return;
+  for (uint8_t i = 0; i < INT_COUNT; i++) {
+    if (!extPending[i]) continue;
+    extPending[i] = false;
+    if (extIsr[i]) callIsr(extIsr[i]);
+  }
+  if ((TIFR1 & _BV(OCF1A)) && (TIMSK1 & _BV(OCIE1A)) && TIMER1_COMPA_vect) {
+    TIFR1 &= ~_BV(OCF1A);
+    callIsr(TIMER1_COMPA_vect);
+  }
+}
+
+static uint16_t timer1Prescaler() {
+  static const uint16_t prescalers[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+  return prescalers[TCCR1B & 0x07];
+}
+
+// --- Timer1 en mode CTC (WGM12), seul mode utilise par le firmware ---
+static void timer1Step() {
+  uint16_t presc = timer1Prescaler();
+  if (!presc) return;
+  if (TCNT1 != lastTcnt) timer1Cycles = (uint64_t)TCNT1 * presc;   // ecrit par le firmware
+  timer1Cycles += 16000;
+  uint64_t top = ((uint64_t)OCR1A + 1) * presc;
+  if (timer1Cycles >= top) {
+    timer1Cycles -= top;
+    TIFR1 |= _BV(OCF1A);
+  }
+  TCNT1 = lastTcnt = timer1Cycles / presc;
+}
+
+void Sim_Advance(uint32_t ms) {
+  while (ms--) {
+    hwMs++;
+    if (TIMSK0 & _BV(TOIE0)) timer0_millis++;
+    else TIFR0 |= _BV(TOV0);
+    timer1Step();
+    Sim_GpsTick(hwMs);
+    if (realTime) usleep(1000);
+    runPending();
+  }
+}
+
+uint64_t Sim_HardwareMs() { return hwMs; }
+void Sim_RealTime(bool on) { realTime = on; }
+
+// --- Sommeil : jusqu'a la prochaine interruption ou un octet recu sur Serial ---
+void Sim_Sleep() {
+  uint32_t count = interruptCount;
+  for (uint32_t n = 0; n < 60000UL && interruptCount == count && !Serial.available(); n++) Sim_Advance(1);
+}
+
+unsigned long millis() { return timer0_millis; }
+unsigned long micros() { return timer0_millis * 1000UL; }
+void delay(unsigned long ms) { Sim_Advance(ms); }
+void delayMicroseconds(unsigned int us) { (void)us; }
+
+void noInterrupts() { SREG &= ~0x80; }
+void interrupts() { SREG |= 0x80; runPending(); }
+
+// --- Broches ---
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+int digitalRead(uint8_t pin) { return pin < PIN_COUNT ? pinLevel[pin] : LOW; }
+void digitalWrite(uint8_t pin, uint8_t value) { if (pin < PIN_COUNT) pinLevel[pin] = value ? HIGH : LOW; }
+int analogRead(uint8_t pin) {
+  if (pin < A0) pin += A0;
+  return pin < PIN_COUNT ? analogValue[pin] : 0;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {
+  if (interrupt >= INT_COUNT) return;
+  extIsr[interrupt] = isr;
+  extMode[interrupt] = mode;
+}
+
+void detachInterrupt(uint8_t interrupt) {
+  if (interrupt < INT_COUNT) extIsr[interrupt] = nullptr;
+}
+
+void Sim_SetPin(uint8_t pin, uint8_t level) {
+  if (pin >= PIN_COUNT) return;
+  level = level ? HIGH : LOW;
+  if (pinLevel[pin] == level) return;
+  pinLevel[pin] = level;
+  int i = digitalPinToInterrupt(pin);
+  if (i < 0 || !extIsr[i]) return;
+  if (extMode[i] == CHANGE || (extMode[i] == RISING && level) || (extMode[i] == FALLING && !level)) {
+    extPending[i] = true;
+    runPending();
+  }
+}
+
+void Sim_SetAnalog(uint8_t pin, int value) {
+  if (pin < A0) pin += A0;
+  if (pin < PIN_COUNT) analogValue[pin] = value;
+}
+
+// --- Print ---
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *s = &buf[sizeof(buf) - 1];
+  *s = '\0';
+  if (base < 2) base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--s = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(s);
+}
+
+size_t Print::print(long n, int base) {
+  if (base == 10 && n < 0) {
+    size_t t = print('-');
+    return t + print((unsigned long)-n, 10);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(double number, int digits) {
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0 || number < -4294967040.0) return print("ovf");
+
+  size_t n = 0;
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+  double rounding = 0.5;
+  for (int i = 0; i < digits; i++) rounding /= 10.0;
+  number += rounding;
+
+  unsigned long whole = (unsigned long)number;
+  double remainder = number - (double)whole;
+  n += print(whole);
+  if (digits > 0) n += print('.');
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int digit = (unsigned int)remainder;
+    n += print(digit);
+    remainder -= digit;
+  }
+  return n;
+}
+
+// --- Serial ---
+HardwareSerial Serial;
+
+static std::string serialIn;
+static size_t serialPos = 0;
+static bool serialStdin = false;
+static bool serialEcho = true;
+static uint32_t serialBytesOut = 0;
+
+static void pollStdin() {
+  if (!serialStdin) return;
+  struct pollfd p = { 0, POLLIN, 0 };
+  while (poll(&p, 1, 0) > 0 && (p.revents & (POLLIN | POLLHUP))) {
+    char buf[256];
+    ssize_t n = ::read(0, buf, sizeof(buf));
+    if (n <= 0) {
+      serialStdin = false;   // fin de stdin
+      return;
+    }
+    serialIn.append(buf, n);
+  }
+}
+
+int HardwareSerial::available() {
+  pollStdin();
+  return serialIn.size() - serialPos;
+}
+
+int HardwareSerial::peek() {
+  return available() ? (uint8_t)serialIn[serialPos] : -1;
+}
+
+int HardwareSerial::read() {
+  if (!available()) return -1;
+  int c = (uint8_t)serialIn[serialPos++];
+  if (serialPos == serialIn.size()) {
+    serialIn.clear();
+    serialPos = 0;
+  }
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  serialBytesOut++;
+  if (serialEcho) putchar(c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  serialBytesOut += size;
+  if (serialEcho) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+void HardwareSerial::flush() {
+  if (serialEcho) fflush(stdout);
+}
+
+void Sim_SerialInput(const char *text) { serialIn.append(text); }
+size_t Sim_SerialPending() { return serialIn.size() - serialPos; }
+void Sim_SerialStdin(bool on) { serialStdin = on; }
+void Sim_SerialEcho(bool on) { serialEcho = on; }
+uint32_t Sim_SerialBytesOut() { return serialBytesOut; }
+
+// --- Calendrier (secondes depuis 2000-01-01, annees 2000..2099) ---
+static const uint16_t daysBeforeMonth[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+uint32_t Sim_DateToUtc(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second) {
+  uint16_t y = year - 2000;
+  uint32_t days = y * 365UL + (y + 3) / 4 + daysBeforeMonth[month - 1] + day - 1;
+  if (month > 2 && y % 4 == 0) days++;
+  return days * 86400UL + hour * 3600UL + minute * 60UL + second;
+}
+
+void Sim_UtcToDate(uint32_t t, uint16_t &year, uint8_t &month, uint8_t &day,
+                   uint8_t &hour, uint8_t &minute, uint8_t &second) {
+  uint32_t days = t / 86400UL;
+  uint32_t s = t % 86400UL;
+  hour = s / 3600;
+  minute = s / 60 % 60;
+  second = s % 60;
+  year = 2000;
+  for (;;) {
+    uint16_t len = (year % 4 == 0) ? 366 : 365;
+    if (days < len) break;
+    days -= len;
+    year++;
+  }
+  bool leap = year % 4 == 0;
+  month = 12;
+  while (month > 1 && days < daysBeforeMonth[month - 1] + (uint32_t)(leap && month > 2)) month--;
+  day = days - daysBeforeMonth[month - 1] - (leap && month > 2) + 1;
+}
+
+// --- Heure UTC simulee (RTC et GPS) ---
+static uint32_t utcBase = 770558400UL;   // 2024-06-01 12:00:00
+static uint64_t utcBaseMs = 0;
+
+void Sim_SetUtc(uint32_t t) {
+  utcBase = t;
+  utcBaseMs = hwMs;
+}
+
+uint32_t Sim_Utc() {
+  return utcBase + (hwMs - utcBaseMs) / 1000;
+}
+
+// --- Programme hote : setup() puis loop(), une milliseconde simulee par passage ---
+#ifndef UNIT_TEST
+void setup();
+void loop();
+
+static volatile sig_atomic_t stopRequested = 0;
+static void onSignal(int) { stopRequested = 1; }
+
+struct Press { uint8_t pin; uint32_t ms; };
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-s secondes] [-d dossier] [-t AAAA-MM-JJ-HH-MM-SS] [-b broche[:ms]]... [-r]\n"
+          "  -s  duree simulee (0 : jusqu'a Ctrl-C)\n"
+          "  -d  dossier de la carte SD (defaut sd_card)\n"
+          "  -t  heure UTC de depart (RTC et GPS)\n"
+          "  -b  appui sur un bouton (2 : rouge, 3 : vert), 100 ms par defaut\n"
+          "  -r  temps reel\n"
+          "Les commandes de la console sont lues sur stdin.\n", prog);
+}
+
+int main(int argc, char **argv) {
+  uint32_t seconds = 0;
+  Press presses[8];
+  uint8_t pressCount = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "s:d:t:b:rh")) != -1) {
+    switch (opt) {
+      case 's': seconds = strtoul(optarg, NULL, 10); break;
+      case 'd': Sim_SdRoot(optarg); break;
+      case 't': {
+        unsigned y, mo, d, h, mi, s;
+        if (sscanf(optarg, "%u-%u-%u-%u-%u-%u", &y, &mo, &d, &h, &mi, &s) != 6 || y < 2000 || y > 2099 ||
+            mo < 1 || mo > 12) {
+          usage(argv[0]);
+          return 2;
+        }
+        Sim_SetUtc(Sim_DateToUtc(y, mo, d, h, mi, s));
+        break;
+      }
+      case 'b': {
+        if (pressCount == sizeof(presses) / sizeof(presses[0])) break;
+        char *end;
+        presses[pressCount].pin = strtoul(optarg, &end, 10);
+        presses[pressCount].ms = *end == ':' ? strtoul(end + 1, NULL, 10) : 100;
+        pressCount++;
+        break;
+      }
+      case 'r': realTime = true; break;
+      case 'h': usage(argv[0]); return 0;
+      default: usage(argv[0]); return 2;
+    }
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  Sim_SerialStdin(true);
+
+  setup();
+
+  // Appuis enchaines, une seconde apres la fin de setup() puis une seconde d'ecart
+  uint64_t nextPress = hwMs + 1000, release = 0;
+  uint8_t pressIndex = 0;
+  uint64_t end = seconds ? hwMs + seconds * 1000ULL : 0;
+
+  while (!stopRequested && (!end || hwMs < end)) {
+    if (release && hwMs >= release) {
+      Sim_SetPin(presses[pressIndex].pin, HIGH);
+      release = 0;
+      pressIndex++;
+      nextPress = hwMs + 1000;
+    } else if (!release && pressIndex < pressCount && hwMs >= nextPress) {
+      Sim_SetPin(presses[pressIndex].pin, LOW);
+      release = hwMs + presses[pressIndex].ms;
+    }
+    loop();
+    Sim_Advance(1);
+  }
+  fflush(stdout);
+  return 0;
+}
+#endif // UNIT_TEST
@@ -0,0 +1,38 @@
+#include <ChainableLED.h>
+
+static ChainableLED *lastLed = nullptr;
+
+ChainableLED::ChainableLED(byte clockPin, byte dataPin, byte numberOfLeds) {
+  (void)clockPin;
+  (void)dataPin;
+  count = numberOfLeds < NATIVE_LED_MAX ? numberOfLeds : NATIVE_LED_MAX;
+  memset(colors, 0, sizeof(colors));
+  lastLed = this;
+}
+
+ChainableLED::~ChainableLED() {
+  if (lastLed == this) lastLed = nullptr;
+}
+
+void ChainableLED::setColorRGB(byte led, byte red, byte green, byte blue) {
+  if (led >= count) return;
+  colors[led][0] = red;
+  colors[led][1] = green;
+  colors[led][2] = blue;
+}
+
+void ChainableLED::setColorHSL(byte led, float hue, float saturation, float lightness) {
+  // Gris de meme luminosite : suffisant pour les tests, le firmware utilise RGB
+  (void)hue;
+  (void)saturation;
+  uint8_t v = lightness * 255;
+  setColorRGB(led, v, v, v);
+}
+
+void Sim_LedColor(uint8_t led, uint8_t &r, uint8_t &g, uint8_t &b) {
+  r = g = b = 0;
+  if (!lastLed || led >= lastLed->count) return;
+  r = lastLed->colors[led][0];
+  g = lastLed->colors[led][1];
+  b = lastLed->colors[led][2];
+}
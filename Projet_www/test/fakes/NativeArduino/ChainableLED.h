@@ -0,0 +1,22 @@
+#ifndef NATIVE_CHAINABLE_LED_H
+#define NATIVE_CHAINABLE_LED_H
+
+// LED RGB chainables : la couleur est seulement memorisee (Sim_LedColor).
+
+#include <Arduino.h>
+
+#define NATIVE_LED_MAX 8
+
+class ChainableLED {
+public:
+  ChainableLED(byte clockPin, byte dataPin, byte numberOfLeds);
+  ~ChainableLED();
+  void init() {}
+  void setColorRGB(byte led, byte red, byte green, byte blue);
+  void setColorHSL(byte led, float hue, float saturation, float lightness);
+
+  uint8_t colors[NATIVE_LED_MAX][3];
+  uint8_t count;
+};
+
+#endif // NATIVE_CHAINABLE_LED_H
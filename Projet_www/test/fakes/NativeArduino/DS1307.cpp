@@ -0,0 +1,43 @@
+#include <DS1307.h>
+
+static int32_t rtcOffset = 0;        // RTC - Sim_Utc(), en secondes
+static uint32_t stoppedAt = 0;
+static bool stopped = false;
+
+static uint32_t rtcNow() {
+  return stopped ? stoppedAt : Sim_Utc() + rtcOffset;
+}
+
+void Sim_RtcOffset(int32_t seconds) { rtcOffset = seconds; }
+
+void DS1307::stopClock() {
+  running = false;
+  stoppedAt = rtcNow();
+  stopped = true;
+}
+
+void DS1307::getTime() {
+  uint16_t y;
+  Sim_UtcToDate(rtcNow(), y, month, dayOfMonth, hour, minute, second);
+  year = y - 2000;
+  dayOfWeek = (rtcNow() / 86400UL + 5) % 7 + 1;    // 2000-01-01 : samedi (1 = lundi)
+}
+
+void DS1307::setTime() {
+  uint32_t t = Sim_DateToUtc(2000 + year % 100, month, dayOfMonth, hour, minute, second);
+  rtcOffset = (int32_t)(t - Sim_Utc());
+  stopped = false;
+  running = true;
+}
+
+void DS1307::fillByHMS(uint8_t _hour, uint8_t _minute, uint8_t _second) {
+  hour = _hour;
+  minute = _minute;
+  second = _second;
+}
+
+void DS1307::fillByYMD(uint16_t _year, uint8_t _month, uint8_t _day) {
+  year = _year - 2000;
+  month = _month;
+  dayOfMonth = _day;
+}
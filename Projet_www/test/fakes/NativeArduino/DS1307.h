@@ -0,0 +1,28 @@
+#ifndef NATIVE_DS1307_H
+#define NATIVE_DS1307_H
+
+// RTC DS1307 simulee : suit Sim_Utc(), decalee par setTime() ou Sim_RtcOffset().
+// Meme interface que la bibliotheque Seeed (year : 0..99 apres 2000).
+
+#include <Arduino.h>
+
+class DS1307 {
+public:
+  void begin() {}
+  void startClock() { running = true; }
+  void stopClock();
+  void setTime();
+  void getTime();
+  void fillByHMS(uint8_t _hour, uint8_t _minute, uint8_t _second);
+  void fillByYMD(uint16_t _year, uint8_t _month, uint8_t _day);
+  void fillDayOfWeek(uint8_t _dow) { dayOfWeek = _dow; }
+
+  uint8_t second = 0, minute = 0, hour = 0;
+  uint8_t dayOfWeek = 1, dayOfMonth = 1, month = 1;
+  uint16_t year = 0;
+
+private:
+  bool running = true;
+};
+
+#endif // NATIVE_DS1307_H
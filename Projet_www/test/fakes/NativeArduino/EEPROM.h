@@ -0,0 +1,34 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+// EEPROM de l'ATmega328P (1024 octets, effacee a 0xFF), en RAM.
+
+#include <stdint.h>
+#include <string.h>
+
+#define NATIVE_EEPROM_SIZE 1024
+
+struct EEPROMClass {
+  uint8_t data[NATIVE_EEPROM_SIZE];
+  uint32_t writes = 0;               // octets reellement programmes (usure)
+
+  EEPROMClass() { memset(data, 0xFF, sizeof(data)); }
+  uint8_t read(int address) { return data[address]; }
+  void write(int address, uint8_t value) { data[address] = value; writes++; }
+  void update(int address, uint8_t value) { if (data[address] != value) write(address, value); }
+  uint16_t length() { return sizeof(data); }
+
+  template <class T> T &get(int address, T &t) {
+    memcpy(&t, data + address, sizeof(T));
+    return t;
+  }
+  template <class T> const T &put(int address, const T &t) {
+    const uint8_t *p = (const uint8_t *)&t;
+    for (size_t i = 0; i < sizeof(T); i++) update(address + i, p[i]);
+    return t;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // NATIVE_EEPROM_H
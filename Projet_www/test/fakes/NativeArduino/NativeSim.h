@@ -0,0 +1,62 @@
+#ifndef NATIVE_SIM_H
+#define NATIVE_SIM_H
+
+// Pilotage de la simulation env:native : horloge, broches, flux GPS, BME280,
+// carte SD. Utilise par test/test_bench et par le main() du programme hote.
+//
+// Deux horloges : le temps materiel (Timer1, RTC, GPS) avance toujours ;
+// millis() (timer0_millis) seulement tant que l'interruption Timer0 est
+// autorisee, comme sur l'AVR. PowerManager compense le sommeil lui-meme.
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Horloge ---
+void Sim_Advance(uint32_t ms);             // avance le temps materiel, interruptions comprises
+uint64_t Sim_HardwareMs();                 // temps materiel depuis le demarrage
+void Sim_SetUtc(uint32_t t);               // secondes depuis 2000-01-01 (RTC et GPS), au temps courant
+uint32_t Sim_Utc();
+void Sim_RealTime(bool on);                // une milliseconde simulee = une milliseconde reelle
+
+// --- Broches ---
+void Sim_SetPin(uint8_t pin, uint8_t level);   // declenche l'interruption attachee au front
+void Sim_SetAnalog(uint8_t pin, int value);
+
+// --- Serial ---
+void Sim_SerialInput(const char *text);    // ajoute au flux lu par Serial
+size_t Sim_SerialPending();                // octets pas encore lus par le firmware
+void Sim_SerialStdin(bool on);             // lit aussi stdin (sans bloquer)
+void Sim_SerialEcho(bool on);              // sortie vers stdout (sinon seulement comptee)
+uint32_t Sim_SerialBytesOut();
+
+// --- GPS (SoftwareSerial, 9600 bauds : un octet par milliseconde) ---
+void Sim_GpsAuto(bool on);                 // RMC + GGA chaque seconde (actif par defaut)
+void Sim_GpsPosition(int32_t lat, int32_t lon);   // millioniemes de degre
+void Sim_GpsFeed(const char *nmea);        // octets envoyes au rythme de la liaison
+size_t Sim_GpsInject(const char *data, size_t len);   // directement dans le tampon de reception
+bool Sim_GpsStandby();                     // recepteur en veille (PMTK161)
+
+// --- BME280 (I2C 0x76) ---
+void Sim_Bme280Present(bool on);
+void Sim_Bme280Raw(uint32_t adcT, uint32_t adcP, uint16_t adcH);
+
+// --- RTC DS1307 ---
+void Sim_RtcOffset(int32_t seconds);       // ecart de la RTC par rapport a Sim_Utc()
+
+// --- Carte SD (repertoire du PC) ---
+void Sim_SdRoot(const char *dir);          // "sd_card" par defaut, cree au besoin
+const char *Sim_SdRootDir();
+void Sim_SdPresent(bool on);
+void Sim_SdFree(long bytes);               // place restante, -1 : illimitee
+
+// --- LED ---
+void Sim_LedColor(uint8_t led, uint8_t &r, uint8_t &g, uint8_t &b);
+
+// --- Usage interne des fakes ---
+void Sim_UtcToDate(uint32_t t, uint16_t &year, uint8_t &month, uint8_t &day,
+                   uint8_t &hour, uint8_t &minute, uint8_t &second);
+uint32_t Sim_DateToUtc(uint16_t year, uint8_t month, uint8_t day,
+                       uint8_t hour, uint8_t minute, uint8_t second);
+void Sim_GpsTick(uint64_t ms);             // appele par Sim_Advance a chaque milliseconde
+
+#endif // NATIVE_SIM_H
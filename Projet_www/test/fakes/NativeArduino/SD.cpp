@@ -0,0 +1,191 @@
+#include <SD.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+
+SDClass SD;
+
+static std::string rootDir = "sd_card";
+static bool cardPresent = true;
+static long freeBytes = -1;
+
+void Sim_SdRoot(const char *dir) { rootDir = dir; }
+const char *Sim_SdRootDir() { return rootDir.c_str(); }
+void Sim_SdPresent(bool on) { cardPresent = on; }
+void Sim_SdFree(long bytes) { freeBytes = bytes; }
+
+static std::string hostPath(const char *name) {
+  while (*name == '/') name++;
+  return rootDir + "/" + name;
+}
+
+// --- Noms 8.3, comme SdFile::make83Name : refuses par la bibliotheque sinon ---
+static bool valid83(const char *path) {
+  while (*path == '/') path++;
+  while (*path) {
+    uint8_t len = 0, max = 8;
+    bool dot = false;
+    for (; *path && *path != '/'; path++) {
+      char c = *path;
+      if (c == '.' && !dot) {
+        if (!len) return false;
+        dot = true;
+        len = 0;
+        max = 3;
+        continue;
+      }
+      if (c < 0x21 || c == 0x7F || strchr("|<>^+=?/[];,*\"\\.", c) || ++len > max) return false;
+    }
+    if (!len) return false;   // composant vide ou extension vide
+    while (*path == '/') path++;
+  }
+  return true;
+}
+
+// --- File ---
+File::File() : _file(nullptr), _dir(nullptr) {
+  _name[0] = '\0';
+  _path[0] = '\0';
+}
+
+File::File(void *file, const char *name) : _file(file), _dir(nullptr) {
+  snprintf(_name, sizeof(_name), "%s", name);
+  _path[0] = '\0';
+}
+
+File::File(void *dir, const char *name, const char *path) : _file(nullptr), _dir(dir) {
+  snprintf(_name, sizeof(_name), "%s", name);
+  snprintf(_path, sizeof(_path), "%s", path);
+}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+  if (!_file || !cardPresent) return 0;
+  if (freeBytes >= 0) {
+    // Seuls les octets au-dela de la fin agrandissent le fichier
+    long pos = ftell((FILE *)_file);
+    long grow = pos + (long)size - (long)this->size();
+    if (grow > freeBytes) size -= grow - freeBytes;
+    if (grow > 0) freeBytes -= grow < freeBytes ? grow : freeBytes;
+  }
+  return fwrite(buffer, 1, size, (FILE *)_file);
+}
+
+int File::read() {
+  if (!_file || !cardPresent) return -1;
+  return fgetc((FILE *)_file);
+}
+
+int File::read(void *buffer, uint16_t len) {
+  if (!_file || !cardPresent) return -1;
+  return fread(buffer, 1, len, (FILE *)_file);
+}
+
+int File::peek() {
+  int c = read();
+  if (c >= 0) ungetc(c, (FILE *)_file);
+  return c;
+}
+
+int File::available() { return _file ? size() - position() : 0; }
+
+void File::flush() {
+  if (_file) fflush((FILE *)_file);
+}
+
+bool File::seek(uint32_t pos) { return _file && fseek((FILE *)_file, pos, SEEK_SET) == 0; }
+
+uint32_t File::position() { return _file ? ftell((FILE *)_file) : 0; }
+
+uint32_t File::size() {
+  if (!_file) return 0;
+  // Taille vue par le systeme de fichiers, ecritures en attente comprises
+  fflush((FILE *)_file);
+  struct stat st;
+  return fstat(fileno((FILE *)_file), &st) == 0 ? st.st_size : 0;
+}
+
+void File::close() {
+  if (_file) fclose((FILE *)_file);
+  if (_dir) closedir((DIR *)_dir);
+  _file = _dir = nullptr;
+}
+
+File::operator bool() { return _file || _dir; }
+
+char *File::name() { return _name; }
+
+bool File::isDirectory() { return _dir != nullptr; }
+
+File File::openNextFile(uint8_t mode) {
+  if (!_dir || !cardPresent) return File();
+  struct dirent *e;
+  while ((e = readdir((DIR *)_dir))) {
+    if (e->d_name[0] == '.' || !valid83(e->d_name)) continue;
+    std::string path = std::string(_path) + "/" + e->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      DIR *d = opendir(path.c_str());
+      if (d) return File(d, e->d_name, path.c_str());
+      continue;
+    }
+    FILE *f = fopen(path.c_str(), (mode & O_WRITE) ? "r+b" : "rb");
+    if (f) return File(f, e->d_name);
+  }
+  return File();
+}
+
+void File::rewindDirectory() {
+  if (_dir) rewinddir((DIR *)_dir);
+}
+
+// --- SDClass ---
+bool SDClass::begin(uint8_t csPin) {
+  (void)csPin;
+  if (!cardPresent) return false;
+  ::mkdir(rootDir.c_str(), 0755);
+  return true;
+}
+
+File SDClass::open(const char *filepath, uint8_t mode) {
+  if (!cardPresent) return File();
+  std::string path = hostPath(filepath);
+  if (strcmp(filepath, "/") && !valid83(filepath)) return File();
+
+  struct stat st;
+  bool exists = stat(path.c_str(), &st) == 0;
+  if (exists && S_ISDIR(st.st_mode)) {
+    DIR *d = opendir(path.c_str());
+    return d ? File(d, filepath, path.c_str()) : File();
+  }
+
+  FILE *f = nullptr;
+  if (!(mode & O_WRITE)) f = fopen(path.c_str(), "rb");
+  else if (exists) f = fopen(path.c_str(), (mode & O_TRUNC) ? "w+b" : "r+b");
+  else if (mode & O_CREAT) f = fopen(path.c_str(), "w+b");
+  if (!f) return File();
+  if (mode & (O_AT_END | O_APPEND)) fseek(f, 0, SEEK_END);
+
+  const char *base = strrchr(filepath, '/');
+  return File(f, base ? base + 1 : filepath);
+}
+
+bool SDClass::exists(const char *filepath) {
+  struct stat st;
+  return cardPresent && valid83(filepath) && stat(hostPath(filepath).c_str(), &st) == 0;
+}
+
+bool SDClass::mkdir(const char *filepath) {
+  return cardPresent && valid83(filepath) && ::mkdir(hostPath(filepath).c_str(), 0755) == 0;
+}
+
+bool SDClass::remove(const char *filepath) {
+  return cardPresent && valid83(filepath) && ::remove(hostPath(filepath).c_str()) == 0;
+}
+
+bool SDClass::rmdir(const char *filepath) {
+  return cardPresent && valid83(filepath) && ::rmdir(hostPath(filepath).c_str()) == 0;
+}
@@ -0,0 +1,65 @@
+#ifndef NATIVE_SD_H
+#define NATIVE_SD_H
+
+// Carte SD simulee par un repertoire du PC (Sim_SdRoot). Meme interface que
+// la bibliotheque Arduino SD : FILE_WRITE ouvre en lecture/ecriture a la fin
+// du fichier, write() est court quand la carte est pleine ou retiree. Les noms
+// qui ne tiennent pas en 8.3 sont refuses, et ignores dans les listes.
+
+#include <Arduino.h>
+
+#define O_READ 0x01
+#define O_WRITE 0x02
+#define O_RDWR (O_READ | O_WRITE)
+#define O_APPEND 0x04
+#define O_CREAT 0x10
+#define O_TRUNC 0x40
+#define O_AT_END 0x80
+
+#define FILE_READ O_READ
+#define FILE_WRITE (O_RDWR | O_CREAT | O_AT_END)
+
+class File : public Stream {
+public:
+  File();
+  File(void *file, const char *name);
+  File(void *dir, const char *name, const char *path);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  int read() override;
+  int read(void *buffer, uint16_t len);
+  int peek() override;
+  int available() override;
+  void flush() override;
+  bool seek(uint32_t pos);
+  uint32_t position();
+  uint32_t size();
+  void close();
+  operator bool();
+  char *name();
+  bool isDirectory();
+  File openNextFile(uint8_t mode = O_READ);
+  void rewindDirectory();
+
+private:
+  void *_file;           // FILE*
+  void *_dir;            // DIR*
+  char _name[13];
+  char _path[256];
+};
+
+class SDClass {
+public:
+  bool begin(uint8_t csPin = 10);
+  void end() {}
+  File open(const char *filepath, uint8_t mode = FILE_READ);
+  bool exists(const char *filepath);
+  bool mkdir(const char *filepath);
+  bool remove(const char *filepath);
+  bool rmdir(const char *filepath);
+};
+
+extern SDClass SD;
+
+#endif // NATIVE_SD_H
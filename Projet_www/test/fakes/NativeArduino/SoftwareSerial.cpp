@@ -0,0 +1,135 @@
+// Recepteur GPS simule. Chaque seconde UTC il emet RMC puis GGA (position
+// Sim_GpsPosition) ; les octets arrivent au rythme de 9600 bauds, un par
+// milliseconde, et debordent si le firmware ne vide pas le tampon a temps.
+// $PMTK161 met le recepteur en veille, n'importe quel octet le reveille.
+
+#include <SoftwareSerial.h>
+#include <string>
+
+static uint8_t rxBuf[_SS_MAX_RX_BUFF];
+static uint8_t rxHead = 0, rxTail = 0;
+static bool rxOverflow = false;
+
+static std::string txQueue;           // octets en cours d'emission par le recepteur
+static size_t txPos = 0;
+static std::string cmdLine;           // commande PMTK en cours de reception
+static bool gpsAuto = true;
+static bool gpsSleeping = false;
+static uint32_t lastSentence = 0;
+static int32_t posLat = 48856600, posLon = 2352200;
+
+SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverseLogic) {
+  (void)receivePin;
+  (void)transmitPin;
+  (void)inverseLogic;
+}
+
+static bool receive(uint8_t c) {
+  uint8_t next = (rxTail + 1) % _SS_MAX_RX_BUFF;
+  if (next == rxHead) {
+    rxOverflow = true;
+    return false;
+  }
+  rxBuf[rxTail] = c;
+  rxTail = next;
+  return true;
+}
+
+bool SoftwareSerial::overflow() {
+  bool o = rxOverflow;
+  rxOverflow = false;
+  return o;
+}
+
+int SoftwareSerial::available() { return (rxTail + _SS_MAX_RX_BUFF - rxHead) % _SS_MAX_RX_BUFF; }
+
+int SoftwareSerial::peek() { return rxHead == rxTail ? -1 : rxBuf[rxHead]; }
+
+int SoftwareSerial::read() {
+  if (rxHead == rxTail) return -1;
+  uint8_t c = rxBuf[rxHead];
+  rxHead = (rxHead + 1) % _SS_MAX_RX_BUFF;
+  return c;
+}
+
+// --- Octets envoyes au recepteur ---
+size_t SoftwareSerial::write(uint8_t c) {
+  gpsSleeping = false;
+  if (c == '\n') {
+    if (!cmdLine.compare(0, 8, "$PMTK161")) gpsSleeping = true;
+    cmdLine.clear();
+  } else if (c != '\r' && cmdLine.size() < 82) {
+    cmdLine += (char)c;
+  }
+  return 1;
+}
+
+// --- Trames NMEA ---
+static void appendSentence(std::string &out, const char *body) {
+  uint8_t cs = 0;
+  for (const char *p = body; *p; p++) cs ^= (uint8_t)*p;
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+  out += '$';
+  out += body;
+  out += tail;
+}
+
+// ddmm.mmmm (latitude) ou dddmm.mmmm (longitude) depuis des millioniemes de degre
+static void formatCoord(char *buf, size_t size, int32_t v, bool lon) {
+  uint32_t a = v < 0 ? -v : v;
+  uint32_t deg = a / 1000000UL;
+  uint32_t tenThousandthsOfMinute = (uint64_t)(a % 1000000UL) * 600000ULL / 1000000ULL;
+  snprintf(buf, size, lon ? "%03u%02u.%04u,%c" : "%02u%02u.%04u,%c", (unsigned)deg,
+           (unsigned)(tenThousandthsOfMinute / 10000), (unsigned)(tenThousandthsOfMinute % 10000),
+           lon ? (v < 0 ? 'W' : 'E') : (v < 0 ? 'S' : 'N'));
+}
+
+static void emitFix(uint32_t t) {
+  uint16_t year;
+  uint8_t month, day, hour, minute, second;
+  Sim_UtcToDate(t, year, month, day, hour, minute, second);
+  char lat[16], lon[16], body[96];
+  formatCoord(lat, sizeof(lat), posLat, false);
+  formatCoord(lon, sizeof(lon), posLon, true);
+
+  snprintf(body, sizeof(body), "GPRMC,%02u%02u%02u.00,A,%s,%s,0.02,0.00,%02u%02u%02u,,,A",
+           hour, minute, second, lat, lon, day, month, year % 100);
+  appendSentence(txQueue, body);
+  snprintf(body, sizeof(body), "GPGGA,%02u%02u%02u.00,%s,%s,1,08,0.95,35.0,M,46.9,M,,",
+           hour, minute, second, lat, lon);
+  appendSentence(txQueue, body);
+}
+
+void Sim_GpsTick(uint64_t ms) {
+  (void)ms;
+  uint32_t t = Sim_Utc();
+  if (gpsAuto && !gpsSleeping && t != lastSentence) {
+    lastSentence = t;
+    emitFix(t);
+  }
+  if (txPos < txQueue.size()) {
+    receive(txQueue[txPos++]);
+    if (txPos == txQueue.size()) {
+      txQueue.clear();
+      txPos = 0;
+    }
+  }
+}
+
+void Sim_GpsAuto(bool on) { gpsAuto = on; }
+
+void Sim_GpsPosition(int32_t lat, int32_t lon) {
+  posLat = lat;
+  posLon = lon;
+}
+
+void Sim_GpsFeed(const char *nmea) { txQueue += nmea; }
+
+size_t Sim_GpsInject(const char *data, size_t len) {
+  size_t n = 0;
+  while (n < len && receive(data[n])) n++;
+  return n;
+}
+
+bool Sim_GpsStandby() { return gpsSleeping; }
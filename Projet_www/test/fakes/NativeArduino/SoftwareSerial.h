@@ -0,0 +1,28 @@
+#ifndef NATIVE_SOFTWARE_SERIAL_H
+#define NATIVE_SOFTWARE_SERIAL_H
+
+// Liaison avec le recepteur GPS simule : tampon de reception de
+// _SS_MAX_RX_BUFF octets avec debordement, comme la bibliotheque AVR.
+
+#include <Arduino.h>
+
+#ifndef _SS_MAX_RX_BUFF
+#define _SS_MAX_RX_BUFF 64
+#endif
+
+class SoftwareSerial : public Stream {
+public:
+  SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverseLogic = false);
+  void begin(long speed) { (void)speed; }
+  bool listen() { return true; }
+  void end() {}
+  bool isListening() { return true; }
+  bool overflow();
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+};
+
+#endif // NATIVE_SOFTWARE_SERIAL_H
@@ -0,0 +1,2 @@
+// Bibliotheques anterieures a Arduino 1.0 (TinyGPSPlus sans ARDUINO defini)
+#include <Arduino.h>
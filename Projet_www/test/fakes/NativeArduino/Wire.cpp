@@ -0,0 +1,122 @@
+// BME280 simule : identifiant, coefficients d'etalonnage de la fiche technique
+// Bosch, conversion en mode force (bit measuring pendant la conversion) et
+// mesures brutes fixees par Sim_Bme280Raw().
+
+#include <Wire.h>
+
+TwoWire Wire;
+
+#define BME280_ADDRESS 0x76
+#define BME280_CONVERSION_MS 10
+
+static bool bmePresent = true;
+static uint8_t regs[256];
+static uint32_t adcT = 519888, adcP = 415148;   // exemple de la fiche technique : 25,08 °C, 1006,5 hPa
+static uint16_t adcH = 30000;
+static uint64_t conversionEnd = 0;
+
+// --- Transaction en cours ---
+static uint8_t txAddress;
+static uint8_t txBuf[32];
+static uint8_t txLen;
+static uint8_t regPointer;
+static uint8_t rxBuf[32];
+static uint8_t rxLen, rxPos;
+
+static void put16(uint8_t reg, uint16_t v) {
+  regs[reg] = v & 0xFF;
+  regs[reg + 1] = v >> 8;
+}
+
+static void resetBme() {
+  memset(regs, 0, sizeof(regs));
+  regs[0xD0] = 0x60;
+  // T1..T3, P1..P9
+  static const uint16_t tp[12] = {27504, 26435, (uint16_t)-1000, 36477, (uint16_t)-10685, 3024,
+                                  2855, 140, (uint16_t)-7, 15500, (uint16_t)-14600, 6000};
+  for (uint8_t i = 0; i < 12; i++) put16(0x88 + 2 * i, tp[i]);
+  // H1, puis H2..H6 (H4 et H5 sur 12 bits partagent 0xE5)
+  const int16_t h4 = 313, h5 = 50;
+  regs[0xA1] = 75;
+  put16(0xE1, 362);
+  regs[0xE3] = 0;
+  regs[0xE4] = h4 >> 4;
+  regs[0xE5] = (h4 & 0x0F) | ((h5 & 0x0F) << 4);
+  regs[0xE6] = h5 >> 4;
+  regs[0xE7] = 30;
+  conversionEnd = 0;
+}
+
+static struct BmeInit { BmeInit() { resetBme(); } } bmeInit;
+
+static void latchMeasurements() {
+  regs[0xF7] = adcP >> 12; regs[0xF8] = adcP >> 4; regs[0xF9] = (adcP & 0x0F) << 4;
+  regs[0xFA] = adcT >> 12; regs[0xFB] = adcT >> 4; regs[0xFC] = (adcT & 0x0F) << 4;
+  regs[0xFD] = adcH >> 8;  regs[0xFE] = adcH & 0xFF;
+}
+
+static uint8_t readReg(uint8_t reg) {
+  if (conversionEnd && Sim_HardwareMs() >= conversionEnd) {
+    conversionEnd = 0;
+    latchMeasurements();
+    regs[0xF4] &= ~0x03;     // retour en sommeil
+  }
+  if (reg == 0xF3) return conversionEnd ? 0x08 : 0x00;
+  return regs[reg];
+}
+
+static void writeReg(uint8_t reg, uint8_t value) {
+  if (reg == 0xE0) {
+    if (value == 0xB6) resetBme();
+    return;
+  }
+  regs[reg] = value;
+  if (reg == 0xF4 && (value & 0x03) == 0x01) conversionEnd = Sim_HardwareMs() + BME280_CONVERSION_MS;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (txLen >= sizeof(txBuf)) return 0;
+  txBuf[txLen++] = c;
+  return 1;
+}
+
+// 0 : succes, 2 : adresse sans reponse
+uint8_t TwoWire::endTransmission(bool stop) {
+  (void)stop;
+  if (txAddress != BME280_ADDRESS || !bmePresent) return 2;
+  if (txLen == 0) return 0;
+  regPointer = txBuf[0];
+  // Ecritures : paires registre / valeur apres le premier octet
+  if (txLen >= 2) {
+    writeReg(txBuf[0], txBuf[1]);
+    for (uint8_t i = 2; i + 1 < txLen; i += 2) writeReg(txBuf[i], txBuf[i + 1]);
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool stop) {
+  (void)stop;
+  rxLen = rxPos = 0;
+  if (address != BME280_ADDRESS || !bmePresent) return 0;
+  if (quantity > sizeof(rxBuf)) quantity = sizeof(rxBuf);
+  for (uint8_t i = 0; i < quantity; i++) rxBuf[i] = readReg(regPointer++);
+  rxLen = quantity;
+  return quantity;
+}
+
+int TwoWire::available() { return rxLen - rxPos; }
+int TwoWire::read() { return rxPos < rxLen ? rxBuf[rxPos++] : -1; }
+int TwoWire::peek() { return rxPos < rxLen ? rxBuf[rxPos] : -1; }
+
+void Sim_Bme280Present(bool on) { bmePresent = on; }
+
+void Sim_Bme280Raw(uint32_t t, uint32_t p, uint16_t h) {
+  adcT = t;
+  adcP = p;
+  adcH = h;
+}
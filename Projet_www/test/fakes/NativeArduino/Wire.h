@@ -0,0 +1,25 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+// Bus I2C simule : un BME280 a l'adresse 0x76 (voir Sim_Bme280*).
+
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+public:
+  void begin() {}
+  void end() {}
+  void setClock(uint32_t hz) { (void)hz; }
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool stop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool stop = true);
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,9 @@
+#ifndef NATIVE_AVR_INTERRUPT_H
+#define NATIVE_AVR_INTERRUPT_H
+
+#include <Arduino.h>
+
+#define sei() interrupts()
+#define cli() noInterrupts()
+
+#endif // NATIVE_AVR_INTERRUPT_H
@@ -0,0 +1,30 @@
+#ifndef NATIVE_AVR_IO_H
+#define NATIVE_AVR_IO_H
+
+// Registres ATmega328P utilises par le firmware, simules par Arduino.cpp.
+
+#include <stdint.h>
+
+extern volatile uint8_t SREG;           // bit 7 : interruptions autorisees
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A;
+extern volatile uint8_t TIMSK0, TIFR0;
+extern volatile uint8_t ADCSRA, PRR, SMCR, MCUSR;
+
+#define WGM12 3
+#define CS12 2
+#define CS10 0
+#define OCIE1A 1
+#define OCF1A 1
+#define TOIE0 0
+#define TOV0 0
+#define ADEN 7
+#define _BV(bit) (1 << (bit))
+
+// Pas de pile a surveiller sur PC : MemoryManager_StackHighWater() renvoie 0
+extern uint8_t __heap_start;
+extern uint8_t *__brkval;
+#define SP ((uintptr_t)&__heap_start)
+#define RAMEND 0x8FF
+
+#endif // NATIVE_AVR_IO_H
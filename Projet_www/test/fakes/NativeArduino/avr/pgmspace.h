@@ -0,0 +1,26 @@
+#ifndef NATIVE_PGMSPACE_H
+#define NATIVE_PGMSPACE_H
+
+// Pas d'espace d'adressage separe sur PC : PROGMEM est de la memoire ordinaire.
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+
+#endif // NATIVE_PGMSPACE_H
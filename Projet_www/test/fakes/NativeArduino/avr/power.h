@@ -0,0 +1,13 @@
+#ifndef NATIVE_AVR_POWER_H
+#define NATIVE_AVR_POWER_H
+
+static inline void power_adc_disable() {}
+static inline void power_adc_enable() {}
+static inline void power_spi_disable() {}
+static inline void power_spi_enable() {}
+static inline void power_twi_disable() {}
+static inline void power_twi_enable() {}
+static inline void power_timer2_disable() {}
+static inline void power_timer2_enable() {}
+
+#endif // NATIVE_AVR_POWER_H
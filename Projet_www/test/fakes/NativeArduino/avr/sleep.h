@@ -0,0 +1,17 @@
+#ifndef NATIVE_AVR_SLEEP_H
+#define NATIVE_AVR_SLEEP_H
+
+// sleep_cpu() avance l'horloge materielle jusqu'a la prochaine interruption Timer1.
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_PWR_SAVE 3
+
+void Sim_Sleep();
+
+static inline void set_sleep_mode(int mode) { (void)mode; }
+static inline void sleep_enable() {}
+static inline void sleep_disable() {}
+static inline void sleep_cpu() { Sim_Sleep(); }
+
+#endif // NATIVE_AVR_SLEEP_H
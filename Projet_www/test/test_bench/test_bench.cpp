@@ -0,0 +1,317 @@
+// Bancs de mesure sur PC (env:native) : cout par operation des chemins
+// chauds du firmware, execute sur les fakes de test/fakes/NativeArduino.
+//
+//   pio test -e native -f test_bench -v
+//
+// Les durees sont celles du PC, pas de l'AVR : elles servent a comparer deux
+// versions du code entre elles, pas a estimer le temps sur la carte. Les
+// assertions ne verifient que la coherence des resultats.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <ConfigManager.h>
+#include <CapteurManager.h>
+#include <clockManager.h>
+#include <fileManager.h>
+#include <RecordFormatter.h>
+
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- Firmware (src/main.cpp, test_build_src = yes) ---
+void setup();
+void loop();
+
+#define BTN_VERT 3
+
+typedef std::chrono::steady_clock Chrono;
+
+static char sdDir[] = "/tmp/www_benchXXXXXX";
+
+// --- Outils ---
+static double elapsedNs(Chrono::time_point start) {
+  return std::chrono::duration<double, std::nano>(Chrono::now() - start).count();
+}
+
+static void report(const char *name, uint32_t ops, double ns, const char *unit) {
+  printf("[BENCH] %-28s %8u %-9s %12.1f ns/%s\n", name, ops, unit, ops ? ns / ops : 0.0, unit);
+}
+
+// --- Firmware en marche : loop() puis une milliseconde simulee ---
+static void run(uint32_t ms) {
+  uint64_t end = Sim_HardwareMs() + ms;
+  while (Sim_HardwareMs() < end) {
+    loop();
+    Sim_Advance(1);
+  }
+}
+
+static void press(uint8_t pin, uint32_t ms) {
+  Sim_SetPin(pin, LOW);
+  run(ms);
+  Sim_SetPin(pin, HIGH);
+  run(500);
+}
+
+static uint32_t countFiles(const char *ext, uint32_t *bytes = nullptr) {
+  uint32_t n = 0;
+  if (bytes) *bytes = 0;
+  DIR *d = opendir(sdDir);
+  if (!d) return 0;
+  while (struct dirent *e = readdir(d)) {
+    const char *dot = strrchr(e->d_name, '.');
+    if (!dot || strcmp(dot + 1, ext)) continue;
+    n++;
+    if (bytes) {
+      char path[300];
+      struct stat st;
+      snprintf(path, sizeof(path), "%s/%s", sdDir, e->d_name);
+      if (stat(path, &st) == 0) *bytes += st.st_size;
+    }
+  }
+  closedir(d);
+  return n;
+}
+
+static void clearSdDir() {
+  DIR *d = opendir(sdDir);
+  if (!d) return;
+  while (struct dirent *e = readdir(d)) {
+    if (e->d_name[0] == '.') continue;
+    char path[300];
+    snprintf(path, sizeof(path), "%s/%s", sdDir, e->d_name);
+    unlink(path);
+  }
+  closedir(d);
+}
+
+// --- Horloge du firmware au debut d'un jour donne (journaux separes par banc) ---
+static void startDay(uint32_t day) {
+  uint16_t year;
+  uint8_t month, dayOfMonth, hour, minute, second;
+  Sim_UtcToDate(Sim_DateToUtc(2024, 7, 1, 0, 0, 0) + day * 86400UL, year, month, dayOfMonth, hour, minute, second);
+  FileManager_Close();
+  setupTime(year, month, dayOfMonth, 0, 0, 0);
+}
+
+static void setMaxFileSize(unsigned int size) {
+  configParams.FILE_MAX_SIZE = size;
+  ConfigManager_save();
+}
+
+static void sampleSummary(LogSummary &s, uint32_t time) {
+  memset(&s, 0, sizeof(s));
+  s.time = time;
+  s.count = 6;
+  s.temperature[LOG_MIN] = 2412; s.temperature[LOG_MEAN] = 2508; s.temperature[LOG_MAX] = 2597;
+  s.humidity[LOG_MIN] = 4410; s.humidity[LOG_MEAN] = 4523; s.humidity[LOG_MAX] = 4698;
+  s.pressure[LOG_MIN] = 10061; s.pressure[LOG_MEAN] = 10065; s.pressure[LOG_MAX] = 10068;
+  s.luminosity[LOG_MIN] = 488; s.luminosity[LOG_MEAN] = 512; s.luminosity[LOG_MAX] = 530;
+  s.errors[4] = 1;
+  s.lat = 48856600;
+  s.lon = 2352200;
+}
+
+// --- Sortie qui ne fait que compter ---
+class NullPrint : public Print {
+public:
+  uint32_t bytes = 0;
+  size_t write(uint8_t) override { bytes++; return 1; }
+  size_t write(const uint8_t *, size_t size) override { bytes += size; return size; }
+};
+
+void setUp() {}
+void tearDown() {}
+
+// --- Une minute de fonctionnement en mode standard ---
+void test_simulated_run() {
+  press(BTN_VERT, 100);
+  auto start = Chrono::now();
+  run(65000);
+  double ns = elapsedNs(start);
+  FileManager_Flush();
+
+  uint32_t bytes;
+  TEST_ASSERT_EQUAL(1, countFiles("LOG", &bytes));
+  TEST_ASSERT_GREATER_THAN(0, bytes);
+  report("loop (1 ms simulee)", 65000, ns, "ms");
+}
+
+// --- RecordFormatter_WriteSummary : ligne texte complete d'un resume ---
+void test_record_format() {
+  const uint32_t n = 20000;
+  LogSummary s;
+  sampleSummary(s, getTimestamp());
+  NullPrint out;
+
+  auto start = Chrono::now();
+  for (uint32_t i = 0; i < n; i++) {
+    s.time++;
+    RecordFormatter_WriteSummary(out, s);
+  }
+  report("RecordFormatter_WriteSummary", n, elapsedNs(start), "op");
+
+  TEST_ASSERT_GREATER_THAN(50 * n, out.bytes);
+  TEST_ASSERT_LESS_THAN(RECORD_SUMMARY_MAX * n, out.bytes);
+}
+
+// --- saveData : trame, tampon de secteur, vidages et index compris ---
+void test_save_data() {
+  const uint32_t n = 3000;
+  const char line[] = "2024-07-02 00:00:00;25.08;45.23;1006.5;512;48.856600;2.352200";
+  startDay(1);
+  setMaxFileSize(65535);
+  uint32_t filesBefore = countFiles("LOG");
+
+  auto start = Chrono::now();
+  uint32_t ok = 0;
+  for (uint32_t i = 0; i < n; i++) ok += saveData(line);
+  double ns = elapsedNs(start);
+  FileManager_Flush();
+
+  TEST_ASSERT_EQUAL(n, ok);
+  report("saveData", n, ns, "op");
+  printf("[BENCH]   %u fichier(s) ouvert(s)\n", countFiles("LOG") - filesBefore);
+}
+
+// --- Rotation : cout d'un nouveau fichier, deduit de deux series de saveSummary ---
+// Serie 1 : FILE_MAX_SIZE minimal, un enregistrement par fichier ; serie 2 :
+// un fichier par jour. Meme nombre d'enregistrements et de changements de jour,
+// carte videe avant chaque jour : l'ouverture du jour parcourt la racine.
+static double saveDays(uint32_t firstDay, uint32_t days, uint32_t perDay, uint32_t &files) {
+  double ns = 0;
+  LogSummary s;
+  files = 0;
+  for (uint32_t d = 0; d < days; d++) {
+    FileManager_Close();
+    clearSdDir();
+    startDay(firstDay + d);
+    auto start = Chrono::now();
+    for (uint32_t i = 0; i < perDay; i++) {
+      sampleSummary(s, getTimestamp() + i);
+      TEST_ASSERT_TRUE(saveSummary(s));
+    }
+    ns += elapsedNs(start);
+    FileManager_Flush();
+    files += countFiles("LOG");
+  }
+  return ns;
+}
+
+void test_rotation() {
+  const uint32_t days = 100, perDay = 9;
+  uint32_t filesSmall, filesLarge;
+
+  setMaxFileSize(512);
+  double nsSmall = saveDays(10, days, perDay, filesSmall);
+  setMaxFileSize(65535);
+  double nsLarge = saveDays(10 + days, days, perDay, filesLarge);
+
+  TEST_ASSERT_GREATER_THAN(filesLarge, filesSmall);
+  report("saveSummary", days * perDay, nsLarge, "op");
+  report("rotation", filesSmall - filesLarge, nsSmall - nsLarge, "fichier");
+}
+
+// --- Console : une commande complete, lecture comprise ---
+static double runCommand(const char *cmd, bool configMode, uint32_t n) {
+  auto start = Chrono::now();
+  for (uint32_t i = 0; i < n; i++) {
+    Sim_SerialInput(cmd);
+    while (Sim_SerialPending()) ConfigManager_Update(configMode);
+  }
+  return elapsedNs(start);
+}
+
+void test_command_parsing() {
+  const uint32_t n = 5000;
+  int interval = configParams.LOG_INTERVAL;
+
+  uint32_t out = Sim_SerialBytesOut();
+  report("commande GET", n, runCommand("get LOG_INTERVAL\n", false, n), "commande");
+  TEST_ASSERT_GREATER_THAN(out, Sim_SerialBytesOut());
+
+  report("commande GET inconnue", n, runCommand("get NOPE\n", false, n), "commande");
+
+  // SET en mode configuration : sauvegarde EEPROM (ConfigStore) comprise
+  uint8_t version = ConfigManager_Version();
+  report("commande SET", n, runCommand("set LOG_INTERVAL 10\n", true, n), "commande");
+  TEST_ASSERT_EQUAL(10, configParams.LOG_INTERVAL);
+  TEST_ASSERT_TRUE(ConfigManager_Version() != version);
+
+  configParams.LOG_INTERVAL = interval;
+  ConfigManager_save();
+}
+
+// --- NMEA : RMC + GGA au rythme du tampon SoftwareSerial (64 octets) ---
+static void appendSentence(char *out, size_t size, const char *body) {
+  uint8_t cs = 0;
+  for (const char *p = body; *p; p++) cs ^= (uint8_t)*p;
+  size_t len = strlen(out);
+  snprintf(out + len, size - len, "$%s*%02X\r\n", body, cs);
+}
+
+void test_nmea_ingestion() {
+  const uint32_t n = 2000;
+  Sim_GpsAuto(false);
+
+  // Heure du firmware : pas de correction de l'horloge par le GPS pendant la mesure
+  uint16_t year;
+  uint8_t month, day, hour, minute, second;
+  Sim_UtcToDate(getTimestamp(), year, month, day, hour, minute, second);
+  char rmc[96], gga[96], pair[256] = "";
+  snprintf(rmc, sizeof(rmc), "GPRMC,%02u%02u%02u.00,A,4530.1234,N,00450.5678,E,0.02,0.00,%02u%02u%02u,,,A",
+           hour, minute, second, day, month, year % 100);
+  snprintf(gga, sizeof(gga), "GPGGA,%02u%02u%02u.00,4530.1234,N,00450.5678,E,1,08,0.95,35.0,M,46.9,M,,",
+           hour, minute, second);
+  appendSentence(pair, sizeof(pair), rmc);
+  appendSentence(pair, sizeof(pair), gga);
+  size_t len = strlen(pair);
+
+  // Reste du flux automatique : le tampon de reception se vide en un passage
+  CapteurManager_UpdateGPS();
+
+  auto start = Chrono::now();
+  for (uint32_t i = 0; i < n; i++) {
+    const char *p = pair;
+    size_t left = len;
+    while (left) {
+      size_t k = Sim_GpsInject(p, left);
+      p += k;
+      left -= k;
+      CapteurManager_UpdateGPS();
+    }
+    CapteurManager_UpdateGPS();
+  }
+  double ns = elapsedNs(start);
+  report("NMEA (octet)", n * len, ns, "octet");
+  report("NMEA (RMC + GGA)", n, ns, "paire");
+
+  int32_t lat, lon;
+  TEST_ASSERT_TRUE(readGPS(lat, lon));
+  TEST_ASSERT_INT32_WITHIN(1, 45502057, lat);
+  TEST_ASSERT_INT32_WITHIN(1, 4842797, lon);
+  Sim_GpsAuto(true);
+}
+
+int main() {
+  if (!mkdtemp(sdDir)) return 1;
+  Sim_SdRoot(sdDir);
+  Sim_SerialEcho(false);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_simulated_run);
+  RUN_TEST(test_record_format);
+  RUN_TEST(test_save_data);
+  RUN_TEST(test_rotation);
+  RUN_TEST(test_command_parsing);
+  RUN_TEST(test_nmea_ingestion);
+  int failures = UNITY_END();
+
+  FileManager_Close();
+  clearSdDir();
+  rmdir(sdDir);
+  return failures;
+}
@@ -0,0 +1,334 @@
+// logdecode : convertit les journaux de la station en CSV sur la sortie
+// standard : binaires (AAMMJJrr.BIN, format decrit dans lib/logFormat/LogFormat.h)
+// ou texte (AAMMJJrr.LOG, lignes de lib/recordFormatter). Memes colonnes pour
+// les deux ; un journal texte ne porte pas le numero de station (colonne vide).
+//
+// Compilation (PC) :
+//   g++ -O2 -std=c++11 -I../../lib/logFormat -I../../lib/crc16 -o logdecode logdecode.cpp
+//
+// Utilisation :
+//   logdecode 25101700.BIN 25101701.BIN > 251017.csv
+//   logdecode 25101700.LOG > 251017.csv
+
+#include <LogFormat.h>
+#include <Crc16.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static_assert(sizeof(LogRecord) == 21, "putRecord() suppose la disposition de LogRecord v1");
+static_assert(sizeof(LogSummary) == 42, "putSummary() suppose la disposition de LogSummary v2");
+
+static const size_t IN_BUFFER = 1 << 16;
+static const size_t OUT_BUFFER = 1 << 16;
+static const size_t LINE_MAX = 512;        // ligne texte la plus longue acceptee
+
+// --- Lecture little-endian, independante de la machine hote ---
+static uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// --- Tampon de sortie : pas de printf par champ ---
+static char outBuf[OUT_BUFFER];
+static size_t outLen = 0;
+
+static void flushOut() {
+  fwrite(outBuf, 1, outLen, stdout);
+  outLen = 0;
+}
+
+static void putStr(const char *s) {
+  while (*s) outBuf[outLen++] = *s++;
+}
+
+static void putSpan(const char *s, size_t n) {
+  if (n) memcpy(outBuf + outLen, s, n);
+  outLen += n;
+}
+
+static void putUInt(uint32_t v, int minDigits = 1) {
+  char tmp[10];
+  int n = 0;
+  do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+  while (n < minDigits) tmp[n++] = '0';
+  while (n) outBuf[outLen++] = tmp[--n];
+}
+
+static void putFixed(int32_t v, int decimals) {
+  static const uint32_t scale[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+  uint32_t u = (uint32_t)v;
+  if (v < 0) { outBuf[outLen++] = '-'; u = 0u - u; }
+  putUInt(u / scale[decimals]);
+  if (decimals) {
+    outBuf[outLen++] = '.';
+    putUInt(u % scale[decimals], decimals);
+  }
+}
+
+// --- Secondes depuis 2000-01-01 -> AAAA-MM-JJTHH:MM:SS ---
+static void putTime(uint32_t t) {
+  uint32_t days = t / 86400, rem = t % 86400;
+  // Algorithme "civil_from_days" (H. Hinnant), decale sur l'epoque 2000-03-01
+  int32_t z = (int32_t)days - 60;
+  int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  uint32_t doe = (uint32_t)(z - era * 146097);
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+  uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+  uint32_t y = 2000 + yoe + era * 400 + (m <= 2);
+
+  putUInt(y, 4); outBuf[outLen++] = '-';
+  putUInt(m, 2); outBuf[outLen++] = '-';
+  putUInt(d, 2); outBuf[outLen++] = 'T';
+  putUInt(rem / 3600, 2); outBuf[outLen++] = ':';
+  putUInt(rem / 60 % 60, 2); outBuf[outLen++] = ':';
+  putUInt(rem % 60, 2);
+}
+
+static void putSep() { outBuf[outLen++] = ','; }
+
+// Extension LOG_MEMORY_WATERMARK, apres l'enregistrement
+static void putWatermark(const uint8_t *r, size_t base, size_t recordSize) {
+  if (recordSize >= base + 2) putUInt(rd16(r + base));
+  outBuf[outLen++] = '\n';
+}
+
+// --- v1 : une acquisition, min = moyenne = max ---
+static void putRecord(uint16_t station, const uint8_t *r, size_t recordSize) {
+  putUInt(station); putSep();
+  putTime(rd32(r + 0)); putSep();
+  putUInt(1); putSep();
+  for (int i = 0; i < 3; ++i) { putFixed((int16_t)rd16(r + 4), 2); putSep(); }
+  for (int i = 0; i < 3; ++i) { putFixed(rd16(r + 6), 2); putSep(); }
+  for (int i = 0; i < 3; ++i) { putFixed(rd16(r + 8), 1); putSep(); }
+  for (int i = 0; i < 3; ++i) { putUInt(rd16(r + 10)); putSep(); }
+  for (int b = 0; b < LOG_ERR_COUNT; ++b) { putUInt((r[12] >> b) & 1); putSep(); }
+  putFixed((int32_t)rd32(r + 13), 6); putSep();
+  putFixed((int32_t)rd32(r + 17), 6); putSep();
+  putWatermark(r, sizeof(LogRecord), recordSize);
+}
+
+// --- v2 : une fenetre agregee (valeurs dans l'ordre min, moyenne, max) ---
+static void putSummary(uint16_t station, const uint8_t *r, size_t recordSize) {
+  static const int order[3] = {LOG_MEAN, LOG_MIN, LOG_MAX};
+  putUInt(station); putSep();
+  putTime(rd32(r + 0)); putSep();
+  putUInt(r[4]); putSep();
+  for (int i = 0; i < 3; ++i) { putFixed((int16_t)rd16(r + 5 + 2 * order[i]), 2); putSep(); }
+  for (int i = 0; i < 3; ++i) { putFixed(rd16(r + 11 + 2 * order[i]), 2); putSep(); }
+  for (int i = 0; i < 3; ++i) { putFixed(rd16(r + 17 + 2 * order[i]), 1); putSep(); }
+  for (int i = 0; i < 3; ++i) { putUInt(rd16(r + 23 + 2 * order[i])); putSep(); }
+  for (int b = 0; b < LOG_ERR_COUNT; ++b) { putUInt(r[29 + b]); putSep(); }
+  putFixed((int32_t)rd32(r + 34), 6); putSep();
+  putFixed((int32_t)rd32(r + 38), 6); putSep();
+  putWatermark(r, sizeof(LogSummary), recordSize);
+}
+
+// --- Journal texte : time:...;count:N;temperature:...;...[;errors:...][;ram:N][;seq:N;crc:XXXX] ---
+// Les valeurs sont recopiees telles quelles : memes decimales que le chemin binaire.
+enum TextField {
+  T_TEMP, T_TEMP_MIN, T_TEMP_MAX, T_HYGR, T_HYGR_MIN, T_HYGR_MAX,
+  T_PRESS, T_PRESS_MIN, T_PRESS_MAX, T_LUMIN, T_LUMIN_MIN, T_LUMIN_MAX,
+  T_LAT, T_LON, T_TIME, T_COUNT, T_ERRORS, T_RAM, T_SEQ, T_FIELDS
+};
+
+static const char *const textKeys[T_FIELDS] = {
+  "temperature", "temperature_min", "temperature_max", "humidity", "humidity_min", "humidity_max",
+  "pressure", "pressure_min", "pressure_max", "luminosity", "luminosity_min", "luminosity_max",
+  "lat", "lon", "time", "count", "errors", "ram", "seq"
+};
+
+struct Span {
+  const char *p;
+  size_t n;
+};
+
+static bool isNumber(const Span &v, bool list = false) {
+  if (!v.n) return false;
+  for (size_t i = 0; i < v.n; ++i) {
+    char c = v.p[i];
+    if (!((c >= '0' && c <= '9') || c == '.' || c == '-' || (list && c == ','))) return false;
+  }
+  return true;
+}
+
+static uint32_t spanUInt(const Span &v) {
+  uint32_t u = 0;
+  for (size_t i = 0; i < v.n && v.p[i] >= '0' && v.p[i] <= '9'; ++i) u = u * 10 + (v.p[i] - '0');
+  return u;
+}
+
+// Fin de trame ";crc:XXXX" : CRC16 de la ligne jusqu'a ";crc:" inclus
+static bool checkLineCrc(const char *line, size_t &len) {
+  if (len < 9 || memcmp(line + len - 9, ";crc:", 5)) return true;   // ligne sans trame (avant v3)
+  uint16_t crc = 0;
+  for (size_t i = len - 4; i < len; ++i) {
+    char c = line[i];
+    uint8_t v = (c >= '0' && c <= '9') ? c - '0' : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0xFF;
+    if (v == 0xFF) return false;
+    crc = (uint16_t)((crc << 4) | v);
+  }
+  if (Crc16_Compute(line, len - 4) != crc) return false;
+  len -= 9;
+  return true;
+}
+
+// Une ligne, false si elle n'est pas un enregistrement valide
+static bool putTextLine(const char *line, size_t len) {
+  if (len > LINE_MAX || !checkLineCrc(line, len)) return false;
+
+  Span v[T_FIELDS] = {};
+  for (const char *p = line, *end = line + len; p < end; ) {
+    const char *sep = (const char *)memchr(p, ';', end - p);
+    if (!sep) sep = end;
+    const char *colon = (const char *)memchr(p, ':', sep - p);
+    if (colon) {
+      for (int k = 0; k < T_FIELDS; ++k) {
+        if (strlen(textKeys[k]) == (size_t)(colon - p) && !memcmp(p, textKeys[k], colon - p)) {
+          v[k].p = colon + 1;
+          v[k].n = sep - colon - 1;
+          break;
+        }
+      }
+    }
+    p = sep + 1;
+  }
+
+  if (!isNumber(v[T_TIME])) return false;
+  for (int k = 0; k < T_TIME; ++k) if (v[k].n && !isNumber(v[k])) return false;
+  uint32_t count = v[T_COUNT].n ? spanUInt(v[T_COUNT]) : 1;
+
+  if (outLen > OUT_BUFFER - 2 * LINE_MAX) flushOut();
+  putSep();                                     // pas de station dans un journal texte
+  putTime(spanUInt(v[T_TIME])); putSep();
+  putUInt(count); putSep();
+  // Echantillon seul : min = moyenne = max, comme le chemin binaire v1
+  for (int k = T_TEMP; k < T_LAT; ++k) {
+    const Span &val = v[k].n ? v[k] : v[k - (k - T_TEMP) % 3];
+    putSpan(val.p, val.n); putSep();
+  }
+
+  // errors : masque LOG_ERR_* (echantillon) ou compteurs t,h,p,l,g (fenetre)
+  const Span &e = v[T_ERRORS];
+  if (e.n && memchr(e.p, ',', e.n)) {
+    if (!isNumber(e, true)) return false;
+    const char *p = e.p, *end = e.p + e.n;
+    for (int b = 0; b < LOG_ERR_COUNT; ++b) {
+      const char *comma = (const char *)memchr(p, ',', end - p);
+      if (!comma) comma = end;
+      if (comma > p) putSpan(p, comma - p); else putUInt(0);
+      putSep();
+      p = comma < end ? comma + 1 : end;
+    }
+  } else {
+    uint32_t mask = spanUInt(e);
+    for (int b = 0; b < LOG_ERR_COUNT; ++b) { putUInt((mask >> b) & 1); putSep(); }
+  }
+  putSpan(v[T_LAT].p, v[T_LAT].n); putSep();
+  putSpan(v[T_LON].p, v[T_LON].n); putSep();
+  if (isNumber(v[T_RAM])) putSpan(v[T_RAM].p, v[T_RAM].n);
+  outBuf[outLen++] = '\n';
+  return true;
+}
+
+static uint8_t in[IN_BUFFER];
+
+static void decodeText(FILE *f, const char *path) {
+  size_t have = 0, n, skipped = 0;
+  while ((n = fread(in + have, 1, sizeof(in) - have, f)) > 0) {
+    have += n;
+    size_t pos = 0;
+    const uint8_t *nl;
+    while ((nl = (const uint8_t *)memchr(in + pos, '\n', have - pos)) != NULL) {
+      size_t len = nl - (in + pos);
+      // Lignes vides : fin effacee apres une coupure
+      if (len && !putTextLine((const char *)in + pos, len)) skipped++;
+      pos += len + 1;
+    }
+    if (pos == 0 && have == sizeof(in)) { skipped++; pos = have; }   // pas de fin de ligne
+    memmove(in, in + pos, have - pos);
+    have -= pos;
+  }
+  if (have) fprintf(stderr, "logdecode: %s: %zu octets tronques en fin de fichier\n", path, have);
+  if (skipped) fprintf(stderr, "logdecode: %s: %zu lignes invalides ignorees\n", path, skipped);
+}
+
+static bool decodeFile(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "logdecode: %s: impossible d'ouvrir le fichier\n", path);
+    return false;
+  }
+
+  // Pas d'en-tete binaire : journal texte
+  uint8_t head[sizeof(LogFileHeader)];
+  if (fread(head, 1, sizeof(head), f) != sizeof(head) ||
+      head[0] != LOG_MAGIC_0 || head[1] != LOG_MAGIC_1 ||
+      head[2] != LOG_MAGIC_2 || head[3] != LOG_MAGIC_3) {
+    rewind(f);
+    decodeText(f, path);
+    fclose(f);
+    return true;
+  }
+  uint8_t version = head[4];
+  size_t recordSize = head[5];
+  uint16_t station = rd16(head + 6);
+  void (*put)(uint16_t, const uint8_t *, size_t) = version == 1 ? putRecord : putSummary;
+  // v3 : trame LogFrameHead ... crc autour du LogSummary
+  size_t frame = version >= 3 ? sizeof(LogFrameHead) + sizeof(uint16_t) : 0;
+  size_t minSize = (version == 1 ? sizeof(LogRecord) : sizeof(LogSummary)) + frame;
+  if (version < 1 || version > LOG_SCHEMA_VERSION || recordSize < minSize) {
+    fprintf(stderr, "logdecode: %s: version %u non supportee\n", path, version);
+    fclose(f);
+    return false;
+  }
+
+  // Lecture par gros blocs ; un enregistrement peut chevaucher deux blocs
+  size_t have = 0, n, skipped = 0;
+  while ((n = fread(in + have, 1, sizeof(in) - have, f)) > 0) {
+    have += n;
+    size_t pos = 0;
+    while (have - pos >= recordSize) {
+      const uint8_t *r = in + pos;
+      if (frame && (r[0] != LOG_SYNC ||
+                    Crc16_Compute(r, recordSize - 2) != rd16(r + recordSize - 2))) {
+        // Trame invalide (fin effacee apres une coupure) : LOG_SYNC suivant
+        const uint8_t *next = (const uint8_t *)memchr(r + 1, LOG_SYNC, recordSize - 1);
+        size_t skip = next ? (size_t)(next - r) : recordSize;
+        skipped += skip;
+        pos += skip;
+        continue;
+      }
+      if (outLen > OUT_BUFFER - 512) flushOut();
+      put(station, r + (frame ? sizeof(LogFrameHead) : 0), recordSize - frame);
+      pos += recordSize;
+    }
+    memmove(in, in + pos, have - pos);
+    have -= pos;
+  }
+  if (have) fprintf(stderr, "logdecode: %s: %zu octets tronques en fin de fichier\n", path, have);
+  if (skipped) fprintf(stderr, "logdecode: %s: %zu octets hors trame ignores\n", path, skipped);
+
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Utilisation: logdecode <fichier.BIN|fichier.LOG>...\n");
+    return 2;
+  }
+
+  putStr("station,time,count,"
+         "temperature,temperature_min,temperature_max,humidity,humidity_min,humidity_max,"
+         "pressure,pressure_min,pressure_max,luminosity,luminosity_min,luminosity_max,"
+         "err_temp,err_hygr,err_press,err_lumin,err_gps,lat,lon,stack_free\n");
+  bool ok = true;
+  for (int i = 1; i < argc; ++i) ok = decodeFile(argv[i]) && ok;
+  flushOut();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+// provision : envoie un fichier de configuration complet a une station en une
+// seule trame protegee par CRC (voir "Provisionnement en bloc" dans
+// lib/configManager/ConfigManager.cpp). La station doit etre en mode
+// configuration ; elle valide tout avant d'appliquer et repond ACK ou NAK.
+//
+// Compilation (PC, POSIX) :
+//   g++ -O2 -std=c++11 -I../../lib/crc16 -o provision provision.cpp
+//
+// Utilisation :
+//   provision [-t] [-d ms] /dev/ttyACM0 station.cfg
+//     -t     ajoute CLOCK=<heure locale du PC>
+//     -d ms  attente apres l'ouverture du port (l'Uno redemarre sur DTR), 2000 par defaut
+//
+// Fichier : une ligne NOM=valeur par parametre, '#' pour les commentaires.
+
+#include <Crc16.h>
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+static const int MAX_LINES = 32;
+static const size_t LINE_MAX_LEN = 63;        // CMD_BUFFER (64) - 1 cote station
+static const useconds_t LINE_GAP_US = 30000;  // laisse la station vider son tampon serie
+static const int REPLY_TIMEOUT_MS = 5000;
+
+static char lines[MAX_LINES][LINE_MAX_LEN + 1];
+static int lineCount = 0;
+
+static bool addLine(const char *s) {
+  if (lineCount >= MAX_LINES) {
+    fprintf(stderr, "provision: trop de lignes (max %d)\n", MAX_LINES);
+    return false;
+  }
+  if (strlen(s) > LINE_MAX_LEN) {
+    fprintf(stderr, "provision: ligne trop longue: %s\n", s);
+    return false;
+  }
+  strcpy(lines[lineCount++], s);
+  return true;
+}
+
+// --- Lecture du fichier : lignes NOM=valeur, sans espaces ni commentaires ---
+static bool readConfig(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "provision: %s: impossible d'ouvrir le fichier\n", path);
+    return false;
+  }
+
+  char raw[128];
+  bool ok = true;
+  while (ok && fgets(raw, sizeof(raw), f)) {
+    char *hash = strchr(raw, '#');
+    if (hash) *hash = '\0';
+    char line[128];
+    size_t n = 0;
+    for (char *p = raw; *p; ++p) if (!isspace((unsigned char)*p)) line[n++] = *p;
+    line[n] = '\0';
+    if (n == 0) continue;
+    if (!strchr(line, '=')) {
+      fprintf(stderr, "provision: %s: ligne sans '=': %s\n", path, line);
+      ok = false;
+    }
+    else ok = addLine(line);
+  }
+  fclose(f);
+  return ok;
+}
+
+static bool addClock() {
+  time_t now = time(NULL);
+  struct tm t;
+  localtime_r(&now, &t);
+  char line[80];
+  snprintf(line, sizeof(line), "CLOCK=%04d-%02d-%02d-%02d-%02d-%02d",
+           t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+  return addLine(line);
+}
+
+// --- Port serie : 9600 8N1 brut (un pseudo-terminal est accepte tel quel) ---
+static int openPort(const char *path) {
+  int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "provision: %s: impossible d'ouvrir le port\n", path);
+    return -1;
+  }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B9600);
+    cfsetospeed(&tio, B9600);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+static bool sendLine(int fd, const char *s) {
+  char buf[64];
+  int n = snprintf(buf, sizeof(buf), "%s\n", s);
+  if (write(fd, buf, n) != n) return false;
+  tcdrain(fd);
+  usleep(LINE_GAP_US);
+  return true;
+}
+
+// --- Attend la ligne ACK / NAK, ignore les messages d'information ---
+static int waitReply(int fd) {
+  char line[128];
+  size_t n = 0;
+  struct pollfd p = { fd, POLLIN, 0 };
+  while (poll(&p, 1, REPLY_TIMEOUT_MS) > 0) {
+    char c;
+    if (read(fd, &c, 1) != 1) break;
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (n < sizeof(line) - 1) line[n++] = c;
+      continue;
+    }
+    line[n] = '\0';
+    n = 0;
+    // L'invite "> " de la console peut preceder la reponse sur la meme ligne
+    const char *r = line;
+    while (r[0] == '>' && r[1] == ' ') r += 2;
+    if (!strcmp(r, "ACK")) {
+      printf("provision: configuration appliquee\n");
+      return 0;
+    }
+    if (!strncmp(r, "NAK", 3)) {
+      fprintf(stderr, "provision: refus de la station: %s\n", r);
+      return 1;
+    }
+  }
+  fprintf(stderr, "provision: pas de reponse de la station\n");
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  bool withClock = false;
+  long delayMs = 2000;
+  int opt;
+  while ((opt = getopt(argc, argv, "td:")) != -1) {
+    if (opt == 't') withClock = true;
+    else if (opt == 'd') delayMs = atol(optarg);
+    else optind = argc + 1;
+  }
+  if (argc - optind != 2) {
+    fprintf(stderr, "Utilisation: provision [-t] [-d ms] <port> <fichier.cfg>\n");
+    return 2;
+  }
+
+  if (!readConfig(argv[optind + 1])) return 1;
+  if (withClock && !addClock()) return 1;
+  if (lineCount == 0) {
+    fprintf(stderr, "provision: fichier vide\n");
+    return 1;
+  }
+
+  uint16_t crc = CRC16_INIT;
+  for (int i = 0; i < lineCount; ++i) {
+    crc = Crc16_Compute(lines[i], strlen(lines[i]), crc);
+    crc = Crc16_Update(crc, '\n');
+  }
+
+  int fd = openPort(argv[optind]);
+  if (fd < 0) return 1;
+  usleep(delayMs * 1000);
+  tcflush(fd, TCIFLUSH);
+
+  // Ligne vide d'abord : vide une commande tapee a moitie cote station
+  char begin[16], end[16];
+  snprintf(begin, sizeof(begin), "BEGIN %d", lineCount);
+  snprintf(end, sizeof(end), "END %04X", crc);
+  bool ok = sendLine(fd, "") && sendLine(fd, begin);
+  for (int i = 0; ok && i < lineCount; ++i) ok = sendLine(fd, lines[i]);
+  ok = ok && sendLine(fd, end);
+
+  int rc = ok ? waitReply(fd) : 1;
+  if (!ok) fprintf(stderr, "provision: erreur d'ecriture sur le port\n");
+  close(fd);
+  return rc;
+}